@@ -0,0 +1,92 @@
+/**
+ * @file arbiter_bench.cpp
+ * @brief Per-message cost of A/B line arbitration under copy loss
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Replays the copies of two redundant lines through LineArbiter::accept()
+ * and reports the cost per arbitrated message (both copies of one sequence
+ * number, including the window slide) for several per-line loss rates. Line
+ * B trails line A by a fixed number of sequences, so lost A copies are filled
+ * from B behind the highest sequence seen, as they are on real lines. The
+ * copy streams are generated up front; only the arbitration is timed.
+ *
+ * Command line arguments:
+ *   ./ffp-bench-arbiter [messages] [window] [b_lag] [repetitions]
+ *
+ * Example:
+ *   ./ffp-bench-arbiter 20000000 4096 32 3
+ */
+
+#include "arbiter.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Copy {
+    uint64_t seq;
+    FeedLine line;
+};
+
+/**
+ * @brief Builds the arrival order of both lines' copies
+ *
+ * Copy n of line A arrives just before copy n - @p lag of line B; each copy
+ * is dropped independently with probability @p loss_ppm / 1e6.
+ */
+std::vector<Copy> make_copies(uint64_t messages, uint64_t lag, uint32_t loss_ppm) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<uint32_t> ppm(0, 999'999);
+    std::vector<Copy> copies;
+    copies.reserve(2 * messages);
+    for (uint64_t n = 1; n <= messages + lag; ++n) {
+        if (n <= messages && ppm(rng) >= loss_ppm) copies.push_back({n, FeedLine::A});
+        if (n > lag && ppm(rng) >= loss_ppm) copies.push_back({n - lag, FeedLine::B});
+    }
+    return copies;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const uint64_t messages = argc >= 2 ? std::stoull(argv[1]) : 20'000'000;
+    const size_t window = argc >= 3 ? std::stoull(argv[2]) : 4096;
+    const uint64_t lag = argc >= 4 ? std::stoull(argv[3]) : 32;
+    const int reps = argc >= 5 ? std::stoi(argv[4]) : 3;
+
+    std::cout << "Messages: " << messages << ", window: " << window << ", line B lag: " << lag
+              << " seq, best of " << reps << "\n\n";
+    std::cout << std::left << std::setw(12) << "loss/line" << std::right << std::setw(12) << "ns/msg"
+              << std::setw(12) << "ns/copy" << std::setw(12) << "A wins" << std::setw(12) << "B wins"
+              << std::setw(12) << "gap fills" << std::setw(10) << "lost" << "\n";
+
+    for (uint32_t loss_ppm : {0u, 100u, 10'000u, 100'000u}) {
+        const std::vector<Copy> copies = make_copies(messages, lag, loss_ppm);
+        double best_ns = 1e300;
+        ArbiterStats stats;
+        for (int r = 0; r < reps; ++r) {
+            LineArbiter arb(window);
+            uint64_t forwarded = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (const Copy &c : copies) forwarded += arb.accept(c.seq, c.line);
+            auto t1 = std::chrono::steady_clock::now();
+            best_ns = std::min(best_ns, std::chrono::duration<double, std::nano>(t1 - t0).count());
+            stats = arb.stats();
+            // keep the decisions observable so the timed loop is not elided
+            if (forwarded != stats.forwarded()) std::cerr << "forwarded count mismatch\n";
+        }
+        std::cout << std::left << std::setw(12) << (std::to_string(loss_ppm / 1e4).substr(0, 4) + "%")
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(12) << best_ns / messages
+                  << std::setw(12) << best_ns / copies.size() << std::setw(12) << stats.wins[0] << std::setw(12)
+                  << stats.wins[1] << std::setw(12) << stats.gap_fills << std::setw(10) << stats.lost << "\n";
+    }
+    return 0;
+}
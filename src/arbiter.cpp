@@ -0,0 +1,51 @@
+#include "arbiter.h"
+#include "spsc_ringbuffer.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+inline void publish(MetricsRegion *metrics, const ArbiterStats &st) noexcept {
+    if (!metrics) return;
+    metrics->arb_duplicates.store(st.duplicates, std::memory_order_relaxed);
+    metrics->arb_stale.store(st.stale, std::memory_order_relaxed);
+    metrics->arb_lost.store(st.lost, std::memory_order_relaxed);
+}
+
+inline void forward(SPSCQueue<RawMsg> &out, const RawMsg &m, const std::atomic<bool> &run_flag) {
+    while (!out.try_push(m)) {
+        if (!run_flag.load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+    }
+}
+
+}  // namespace
+
+void arbiter_thread_func(SPSCQueue<RawMsg> &line_a, SPSCQueue<RawMsg> &line_b,
+                         SPSCQueue<RawMsg> &out, std::atomic<bool> &run_flag,
+                         size_t window_pow2, ArbiterStats &stats, MetricsRegion *metrics) {
+    LineArbiter arb(window_pow2);
+    SPSCQueue<RawMsg> *lines[2] = {&line_a, &line_b};
+    unsigned first = 0;
+    uint32_t copies = 0;
+    RawMsg m;
+    while (run_flag.load(std::memory_order_relaxed)) {
+        bool got = false;
+        // alternate which line is polled first so ties do not always favor A
+        for (unsigned k = 0; k < 2; ++k) {
+            unsigned l = first ^ k;
+            if (lines[l]->try_pop(m)) {
+                got = true;
+                if ((++copies & 1023) == 0) publish(metrics, arb.stats());
+                if (arb.accept(m.seq, static_cast<FeedLine>(l))) forward(out, m, run_flag);
+            }
+        }
+        first ^= 1;
+        if (!got) {
+            publish(metrics, arb.stats());
+            std::this_thread::yield();
+        }
+    }
+    stats = arb.stats();
+    publish(metrics, stats);
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "feed_generator.h"
+#include "spsc_ringbuffer.h"
+#include "shm_metrics.h"
+
+/**
+ * @file arbiter.h
+ * @brief A/B redundant feed line arbitration
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Exchanges publish every message on two redundant lines (A and B). This
+ * module merges both lines into a single stream: the first copy of each
+ * sequence number wins, the late copy is dropped, and a message lost on one
+ * line is recovered from the other.
+ */
+
+/**
+ * @enum FeedLine
+ * @brief Identifies which redundant line delivered a message
+ */
+enum class FeedLine : uint8_t {
+    A = 0,  ///< Primary line
+    B = 1   ///< Secondary line
+};
+
+/**
+ * @struct ArbiterStats
+ * @brief Counters describing arbitration outcomes
+ *
+ * Counters are plain integers owned by the arbitrating thread. Read them
+ * only after that thread has been joined.
+ */
+struct ArbiterStats {
+    uint64_t wins[2] = {0, 0};  ///< Messages forwarded from line A / line B
+    uint64_t duplicates = 0;    ///< Late copies of already forwarded messages
+    uint64_t gap_fills = 0;     ///< Messages forwarded behind the highest seen sequence
+    uint64_t stale = 0;         ///< Copies older than the tracking window (dropped)
+    uint64_t lost = 0;          ///< Sequences missing on both lines when leaving the window
+
+    /// @brief Total messages forwarded downstream
+    uint64_t forwarded() const noexcept {
+        return wins[0] + wins[1];
+    }
+};
+
+/**
+ * @class LineArbiter
+ * @brief First-copy-wins sequence arbitration over a bounded bitmap window
+ *
+ * Tracks which sequence numbers have already been forwarded inside a sliding
+ * window ending at the highest sequence seen. Each sequence maps to one bit
+ * (seq & (window - 1)), so the seen-set costs window/8 bytes and every
+ * decision is a shift, a mask and a single word access - no hashing and no
+ * allocation after construction.
+ *
+ * When the window slides forward, bits that leave it without ever having been
+ * set are counted as lost: neither line delivered that sequence in time.
+ *
+ * @note Not thread-safe. One arbiter instance belongs to one thread.
+ *
+ * Example usage:
+ * @code
+ * LineArbiter arb(4096);
+ * if (arb.accept(msg.seq, FeedLine::A)) {
+ *     forward(msg);  // first copy of this sequence
+ * }
+ * @endcode
+ */
+class LineArbiter {
+public:
+    /**
+     * @brief Constructs an arbiter with the given window size
+     *
+     * @param window_pow2 Number of sequences tracked behind the highest seen
+     *                    sequence (power of two, at least 64)
+     *
+     * @throws std::invalid_argument if window_pow2 is not a power of two >= 64
+     */
+    explicit LineArbiter(size_t window_pow2 = 1 << 12)
+        : window_(window_pow2), mask_(window_pow2 - 1), bits_(window_pow2 / 64, 0) {
+        if (window_pow2 < 64 || !std::has_single_bit(window_pow2)) {
+            throw std::invalid_argument("arbiter window must be a power of two >= 64");
+        }
+    }
+
+    /**
+     * @brief Decides whether a copy of @p seq should be forwarded
+     *
+     * @param seq Sequence number carried by the message
+     * @param line Line the copy arrived on
+     * @return true if this is the first copy seen (forward it), false if it
+     *         is a duplicate or too old to arbitrate (drop it)
+     */
+    bool accept(uint64_t seq, FeedLine line) noexcept {
+        if (seq > highest_) [[likely]] {
+            if (highest_ == 0) {
+                base_ = seq;
+                highest_ = seq - 1;
+            }
+            advance(seq);
+            mark(seq);
+            ++stats_.wins[static_cast<size_t>(line)];
+            return true;
+        }
+        if (highest_ - seq >= window_ || seq < base_) {
+            ++stats_.stale;
+            return false;
+        }
+        if (is_marked(seq)) {
+            ++stats_.duplicates;
+            return false;
+        }
+        mark(seq);
+        ++stats_.wins[static_cast<size_t>(line)];
+        ++stats_.gap_fills;
+        return true;
+    }
+
+    /// @brief Arbitration counters accumulated so far
+    const ArbiterStats& stats() const noexcept {
+        return stats_;
+    }
+
+    /// @brief Highest sequence number forwarded so far (0 if none)
+    uint64_t highest() const noexcept {
+        return highest_;
+    }
+
+private:
+    bool is_marked(uint64_t seq) const noexcept {
+        size_t slot = seq & mask_;
+        return (bits_[slot >> 6] >> (slot & 63)) & 1;
+    }
+
+    void mark(uint64_t seq) noexcept {
+        size_t slot = seq & mask_;
+        bits_[slot >> 6] |= 1ULL << (slot & 63);
+    }
+
+    // Slides the window so that it ends at new_high, evicting the slots that
+    // the new sequences reuse and counting evicted sequences never delivered.
+    void advance(uint64_t new_high) noexcept {
+        uint64_t gap = new_high - highest_;
+        if (gap >= window_) {
+            for (uint64_t s = highest_ >= window_ ? highest_ - window_ + 1 : 1; s <= highest_; ++s) {
+                if (s >= base_ && !is_marked(s)) ++stats_.lost;
+            }
+            // Sequences skipped entirely (never inside the window)
+            stats_.lost += gap - window_;
+            std::fill(bits_.begin(), bits_.end(), 0);
+            highest_ = new_high;
+            return;
+        }
+        for (uint64_t s = highest_ + 1; s <= new_high; ++s) {
+            uint64_t evicted = s - window_;
+            size_t slot = s & mask_;
+            uint64_t bit = 1ULL << (slot & 63);
+            if (s > window_ && evicted >= base_ && !(bits_[slot >> 6] & bit)) ++stats_.lost;
+            bits_[slot >> 6] &= ~bit;
+        }
+        highest_ = new_high;
+    }
+
+    size_t window_;               ///< Window size in sequences (power of 2)
+    size_t mask_;                 ///< window_ - 1
+    std::vector<uint64_t> bits_;  ///< One bit per tracked sequence
+    uint64_t highest_ = 0;        ///< Highest sequence seen (0 = nothing seen yet)
+    uint64_t base_ = 0;           ///< First sequence seen; older ones are never counted lost
+    ArbiterStats stats_;
+};
+
+/**
+ * @brief Arbitration stage thread function
+ *
+ * Polls the A and B line queues alternately, forwards the first copy of every
+ * sequence number to @p out and drops the rest. Sequences lost on one line but
+ * delivered on the other are forwarded as soon as the surviving copy arrives,
+ * which may be behind later sequences; downstream stages that need strict
+ * ordering must reorder.
+ *
+ * @param line_a Queue carrying line A copies
+ * @param line_b Queue carrying line B copies
+ * @param out Queue receiving the arbitrated stream
+ * @param run_flag Atomic flag to control thread execution
+ * @param window_pow2 Arbitration window in sequences (power of two, >= 64)
+ * @param stats Receives the final arbitration counters when the thread exits
+ * @param metrics If set, duplicate, stale and lost counts are published here
+ *        while running (when idle and every 1024 copies)
+ *
+ * @note Single consumer of both line queues and single producer of @p out.
+ *
+ * Performance characteristics:
+ * - Arbitration cost: a few ns per copy (one bitmap word read-modify-write)
+ * - Memory usage: window_pow2 / 8 bytes, allocated once at start
+ */
+void arbiter_thread_func(SPSCQueue<RawMsg> &line_a,
+                         SPSCQueue<RawMsg> &line_b,
+                         SPSCQueue<RawMsg> &out,
+                         std::atomic<bool> &run_flag,
+                         size_t window_pow2,
+                         ArbiterStats &stats,
+                         MetricsRegion *metrics = nullptr);
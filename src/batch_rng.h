@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file batch_rng.h
+ * @brief Batched message-content generation with xoshiro256**
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Three std::mt19937_64 draws through uniform_*_distribution objects cost
+ * more than an SPSC enqueue, so at high rates a per-message generator hides
+ * the queue it is meant to load. BatchRng runs four interleaved xoshiro256**
+ * streams and fills the symbol, size and price fields of a whole
+ * MessageBatch at a time: with AVX2 the four streams are the four 64-bit
+ * lanes of one register (xoshiro256** needs only shifts, adds and xors,
+ * which AVX2 has for 64-bit lanes), and the scalar fallback steps the same
+ * streams one after another. Both paths produce bit-identical batches, so a
+ * seed gives the same feed on every machine.
+ *
+ * Fields are derived from the draws without divisions or rejection loops:
+ * symbol and size take the high and low halves of one draw through a
+ * multiply-shift range reduction, and the price takes the top 52 bits of a
+ * second draw as the mantissa of a double in [1, 2), scaled to [100, 200).
+ * A SymbolSampler reads all 64 bits of its input, so a generator built for
+ * one makes a third draw per message into bits; sharing the symbol and size
+ * draw would tie each message's size to the alias column of its symbol.
+ */
+
+/**
+ * @struct MessageBatch
+ * @brief Content fields of kSize consecutive messages
+ */
+struct MessageBatch {
+    static constexpr size_t kSize = 64;  ///< Messages per batch (a multiple of 4)
+
+    alignas(32) uint64_t bits[kSize];    ///< Draw of its own for a SymbolSampler (see BatchRng)
+    alignas(32) double price[kSize];     ///< Uniform in [100, 200)
+    alignas(32) uint32_t symbol[kSize];  ///< Uniform in 1..range
+    alignas(32) uint32_t size[kSize];    ///< Uniform in 1..1000
+};
+
+/**
+ * @struct GeneratorStats
+ * @brief Time the producer spent building message content
+ *
+ * Written by the producer thread only; read after it has been joined.
+ */
+struct GeneratorStats {
+    uint64_t messages = 0;  ///< Messages generated
+    uint64_t ns = 0;        ///< Time spent filling their fields
+
+    /// @brief Mean generation cost per message
+    double ns_per_msg() const noexcept { return messages ? static_cast<double>(ns) / messages : 0.0; }
+};
+
+/**
+ * @class BatchRng
+ * @brief Four-stream xoshiro256** generator of MessageBatch contents
+ *
+ * @note Not thread-safe; one generator belongs to the producer thread.
+ */
+class BatchRng {
+public:
+    /**
+     * @param seed Seed of all four streams (expanded with splitmix64)
+     * @param symbol_range Symbols are drawn from 1..symbol_range
+     * @param sampler_bits Also fill MessageBatch::bits, from a third draw
+     *                     (otherwise bits is left untouched)
+     */
+    explicit BatchRng(uint64_t seed, uint32_t symbol_range, bool sampler_bits = false) noexcept
+        : range_(symbol_range), sampler_bits_(sampler_bits) {
+        for (auto &word : s_) {
+            for (uint64_t &lane : word) {
+                seed += 0x9E3779B97F4A7C15ULL;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                lane = z ^ (z >> 31);
+            }
+        }
+    }
+
+    /// @brief Fills every field of @p b with the next kSize messages
+    void fill(MessageBatch &b) noexcept {
+#if defined(__AVX2__)
+        fill_avx2(b);
+#else
+        fill_scalar(b);
+#endif
+    }
+
+    /// @brief Portable path; identical output to the AVX2 path
+    void fill_scalar(MessageBatch &b) noexcept {
+        for (size_t i = 0; i < MessageBatch::kSize; i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                const uint64_t r = next(lane);
+                b.symbol[i + lane] = static_cast<uint32_t>(((r >> 32) * range_) >> 32) + 1;
+                b.size[i + lane] = static_cast<uint32_t>(((r & 0xFFFFFFFFULL) * 1000) >> 32) + 1;
+                const uint64_t mantissa = (next(lane) >> 12) | 0x3FF0000000000000ULL;
+                double unit;
+                std::memcpy(&unit, &mantissa, sizeof unit);
+                b.price[i + lane] = unit * 100.0;
+                if (sampler_bits_) b.bits[i + lane] = next(lane);
+            }
+        }
+    }
+
+    /// @brief True if fill() uses AVX2
+    static constexpr bool vectorized() noexcept {
+#if defined(__AVX2__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+
+    // One step of stream @p lane
+    uint64_t next(size_t lane) noexcept {
+        uint64_t &s0 = s_[0][lane], &s1 = s_[1][lane], &s2 = s_[2][lane], &s3 = s_[3][lane];
+        const uint64_t result = rotl(s1 * 5, 7) * 9;
+        const uint64_t t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 45);
+        return result;
+    }
+
+#if defined(__AVX2__)
+    template <int K>
+    static __m256i rotl(__m256i x) noexcept {
+        return _mm256_or_si256(_mm256_slli_epi64(x, K), _mm256_srli_epi64(x, 64 - K));
+    }
+
+    void fill_avx2(MessageBatch &b) noexcept {
+        __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s_[0]));
+        __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s_[1]));
+        __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s_[2]));
+        __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s_[3]));
+        auto next = [&] {
+            const __m256i x5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);  // s1 * 5
+            const __m256i r7 = rotl<7>(x5);
+            const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(r7, 3), r7);  // * 9
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotl<45>(s3);
+            return result;
+        };
+        const __m256i range = _mm256_set1_epi64x(range_);
+        const __m256i thousand = _mm256_set1_epi64x(1000);
+        const __m256i one = _mm256_set1_epi64x(1);
+        const __m256i exponent = _mm256_set1_epi64x(0x3FF0000000000000LL);
+        const __m256d hundred = _mm256_set1_pd(100.0);
+        const __m256i low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        for (size_t i = 0; i < MessageBatch::kSize; i += 4) {
+            const __m256i r = next();
+            // mul_epu32 multiplies the low 32 bits of each lane
+            const __m256i sym = _mm256_add_epi64(
+                _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(r, 32), range), 32), one);
+            const __m256i qty = _mm256_add_epi64(_mm256_srli_epi64(_mm256_mul_epu32(r, thousand), 32), one);
+            _mm_store_si128(reinterpret_cast<__m128i *>(b.symbol + i),
+                            _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(sym, low_dwords)));
+            _mm_store_si128(reinterpret_cast<__m128i *>(b.size + i),
+                            _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(qty, low_dwords)));
+            const __m256i mantissa = _mm256_or_si256(_mm256_srli_epi64(next(), 12), exponent);
+            _mm256_store_pd(b.price + i, _mm256_mul_pd(_mm256_castsi256_pd(mantissa), hundred));
+            if (sampler_bits_) _mm256_store_si256(reinterpret_cast<__m256i *>(b.bits + i), next());
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s_[0]), s0);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s_[1]), s1);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s_[2]), s2);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s_[3]), s3);
+    }
+#endif
+
+    alignas(32) uint64_t s_[4][4];  // s_[word][stream]
+    uint64_t range_;
+    bool sampler_bits_;
+};
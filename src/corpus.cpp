@@ -0,0 +1,112 @@
+#include "corpus.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define FFP_HAVE_MMAP 1
+#endif
+
+namespace {
+
+constexpr size_t kHugePage = size_t{2} << 20;
+
+size_t round_up(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+}  // namespace
+
+MessageCorpus::MessageCorpus(size_t count) : count_(count) {
+    if (count == 0 || count > kMaxMessages) {
+        throw std::invalid_argument("corpus must hold 1 to " + std::to_string(kMaxMessages) + " messages");
+    }
+#ifdef FFP_HAVE_MMAP
+    bytes_ = round_up(count * sizeof(RawMsg), kHugePage);
+    void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) backing_ = Backing::HugeTlb;
+#endif
+    if (p == MAP_FAILED) {
+        // No reserved huge pages: ordinary pages, promoted by THP where enabled
+        p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::runtime_error("cannot map " + std::to_string(bytes_ >> 20) + " MB for the corpus: " +
+                                     std::strerror(errno));
+        }
+        backing_ = Backing::Heap;
+#ifdef MADV_HUGEPAGE
+        if (madvise(p, bytes_, MADV_HUGEPAGE) == 0) backing_ = Backing::Transparent;
+#endif
+    }
+    data_ = static_cast<RawMsg *>(p);
+#else
+    bytes_ = count * sizeof(RawMsg);
+    data_ = static_cast<RawMsg *>(::operator new(bytes_, std::align_val_t{64}));
+    std::memset(data_, 0, bytes_);
+#endif
+}
+
+MessageCorpus::MessageCorpus(MessageCorpus &&other) noexcept
+    : data_(other.data_), count_(other.count_), bytes_(other.bytes_), backing_(other.backing_) {
+    other.data_ = nullptr;
+}
+
+MessageCorpus::~MessageCorpus() {
+    if (!data_) return;
+#ifdef FFP_HAVE_MMAP
+    munmap(data_, bytes_);
+#else
+    ::operator delete(data_, std::align_val_t{64});
+#endif
+}
+
+MessageCorpus MessageCorpus::load(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    CorpusFileHeader h;
+    if (!in.read(reinterpret_cast<char *>(&h), sizeof(h)) || h.magic != kCorpusMagic) {
+        throw std::runtime_error(path + " is not a message corpus");
+    }
+    if (h.version != kCorpusVersion) {
+        throw std::runtime_error(path + " has corpus version " + std::to_string(h.version) + ", expected " +
+                                 std::to_string(kCorpusVersion));
+    }
+    if (h.count == 0 || h.count > kMaxMessages) throw std::runtime_error(path + " is corrupt");
+    MessageCorpus c(static_cast<size_t>(h.count));
+    if (!in.read(reinterpret_cast<char *>(c.data_), static_cast<std::streamsize>(c.count_ * sizeof(RawMsg)))) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    return c;
+}
+
+void MessageCorpus::save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary);
+    CorpusFileHeader h;
+    h.count = count_;
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char *>(data_), static_cast<std::streamsize>(count_ * sizeof(RawMsg)));
+    if (!out) throw std::runtime_error("cannot write corpus " + path);
+}
+
+const char *MessageCorpus::backing_name() const noexcept {
+    switch (backing_) {
+    case Backing::HugeTlb:
+        return "2 MB huge pages";
+    case Backing::Transparent:
+        return "transparent huge pages";
+    case Backing::Heap:
+        break;
+    }
+    return "4 KB pages";
+}
+
+uint32_t MessageCorpus::max_symbol() const noexcept {
+    uint32_t m = 0;
+    for (size_t i = 0; i < count_; ++i) m = std::max(m, data_[i].symbol_id);
+    return m;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "feed_generator.h"
+
+/**
+ * @file corpus.h
+ * @brief Pre-generated message corpus for replay runs
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Synthesizing content in the producer's hot loop puts the generator's cost
+ * (and its cache footprint: symbol tables, quote books) on the path the
+ * benchmark is meant to measure. A MessageCorpus holds N messages built
+ * before the run, by generate_messages() or from a file, in one
+ * huge-page-backed buffer; the producer then only copies a record, stamps
+ * seq and t_sent_ns and pushes, looping over the corpus at the configured
+ * rate.
+ *
+ * Corpus files are a CorpusFileHeader followed by the RawMsg records in
+ * host byte order, as written by save().
+ */
+
+/// @brief Corpus file identifier ("FFPC")
+inline constexpr uint32_t kCorpusMagic = 0x43504646;
+
+/// @brief Corpus file layout version
+inline constexpr uint32_t kCorpusVersion = 1;
+
+/**
+ * @struct CorpusFileHeader
+ * @brief Start of a corpus file
+ */
+struct CorpusFileHeader {
+    uint32_t magic = kCorpusMagic;
+    uint32_t version = kCorpusVersion;
+    uint64_t count = 0;  ///< RawMsg records that follow
+};
+static_assert(sizeof(CorpusFileHeader) == 16, "corpus header layout");
+
+/**
+ * @class MessageCorpus
+ * @brief Fixed array of messages in huge-page memory
+ *
+ * The buffer is mapped with explicit 2 MB huge pages when the system has
+ * them reserved (vm.nr_hugepages), and otherwise with ordinary pages marked
+ * for transparent huge pages, so replaying a multi-gigabyte corpus costs
+ * few TLB misses either way.
+ */
+class MessageCorpus {
+public:
+    /// @brief How the buffer is backed
+    enum class Backing { HugeTlb, Transparent, Heap };
+
+    /// @brief Largest corpus, in messages (8 GB)
+    static constexpr size_t kMaxMessages = size_t{1} << 28;
+
+    /**
+     * @brief Allocates room for @p count messages (zeroed)
+     *
+     * @throws std::invalid_argument if count is 0 or above kMaxMessages
+     * @throws std::runtime_error if the memory cannot be mapped
+     */
+    explicit MessageCorpus(size_t count);
+    ~MessageCorpus();
+
+    MessageCorpus(MessageCorpus &&other) noexcept;
+    MessageCorpus(const MessageCorpus &) = delete;
+    MessageCorpus &operator=(const MessageCorpus &) = delete;
+    MessageCorpus &operator=(MessageCorpus &&) = delete;
+
+    /**
+     * @brief Reads a corpus file written by save()
+     *
+     * @throws std::runtime_error if the file is missing, truncated or of another version
+     */
+    static MessageCorpus load(const std::string &path);
+
+    /**
+     * @brief Writes the corpus to @p path
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save(const std::string &path) const;
+
+    RawMsg *data() noexcept { return data_; }
+    const RawMsg *data() const noexcept { return data_; }
+    size_t size() const noexcept { return count_; }
+
+    /// @brief Bytes mapped (rounded up to the page size in use)
+    size_t bytes() const noexcept { return bytes_; }
+
+    Backing backing() const noexcept { return backing_; }
+
+    /// @brief Human-readable backing, e.g. "2 MB huge pages"
+    const char *backing_name() const noexcept;
+
+    /// @brief Largest symbol id in the corpus
+    uint32_t max_symbol() const noexcept;
+
+private:
+    RawMsg *data_ = nullptr;
+    size_t count_ = 0;
+    size_t bytes_ = 0;
+    Backing backing_ = Backing::Heap;
+};
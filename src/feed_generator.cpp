@@ -1,35 +1,209 @@
 #include "feed_generator.h"
 #include "spsc_ringbuffer.h"
+#include "stage_trace.h"
+#include "outlier_tracker.h"
+#include "perf_counters.h"
+#include "flight_recorder.h"
+#include "symbol_sampler.h"
+#include "quote_model.h"
+#include "batch_rng.h"
 #include <thread>
 #include <chrono>
 #include <atomic>
 #include <random>
+#include <algorithm>
 
 using namespace std::chrono;
 
+namespace {
+
+// Pushes with simple backpressure; gives up only when the run is stopping.
+// Returns the time spent waiting for space (0 if the first attempt succeeded).
+inline uint64_t publish(SPSCQueue<RawMsg> &q, const RawMsg &m, const std::atomic<bool> &run_flag) {
+    if (q.try_push(m)) return 0;
+    const auto t0 = steady_clock::now();
+    while (!q.try_push(m)) {
+        if (!run_flag.load(std::memory_order_relaxed)) break;
+        // brief pause to avoid burning 100% CPU if full
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+    return duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+}
+
+// Message content per the content settings of a ProducerConfig, a batch at a time
+class ContentGenerator {
+public:
+    explicit ContentGenerator(const ProducerConfig &cfg)
+        : cfg_(cfg), batch_rng_(cfg.seed, cfg.symbol_range, cfg.symbols != nullptr), rng_(cfg.seed), sym_(1, cfg.symbol_range),
+          qty_(1, 1000), price_(100.0, 200.0) {}
+
+    void fill(MessageBatch &batch) {
+        if (cfg_.batch_rng) {
+            batch_rng_.fill(batch);
+            if (cfg_.symbols) {
+                for (size_t i = 0; i < MessageBatch::kSize; ++i) batch.symbol[i] = (*cfg_.symbols)(batch.bits[i]);
+            }
+        } else {
+            // same draw order as the original per-message generator
+            for (size_t i = 0; i < MessageBatch::kSize; ++i) {
+                batch.symbol[i] = cfg_.symbols ? (*cfg_.symbols)(rng_()) : sym_(rng_);
+                batch.size[i] = qty_(rng_);
+                batch.price[i] = price_(rng_);
+            }
+        }
+        if (cfg_.symbol_base) {
+            for (size_t i = 0; i < MessageBatch::kSize; ++i) batch.symbol[i] += cfg_.symbol_base;
+        }
+        if (cfg_.quotes) {
+            for (size_t i = 0; i < MessageBatch::kSize; ++i) {
+                const QuoteModel::Quote quote = cfg_.quotes->next(batch.symbol[i]);
+                batch.size[i] = quote.size;
+                batch.price[i] = quote.price;
+            }
+        }
+    }
+
+private:
+    const ProducerConfig &cfg_;
+    BatchRng batch_rng_;
+    std::mt19937_64 rng_;
+    std::uniform_int_distribution<uint32_t> sym_;
+    std::uniform_int_distribution<uint32_t> qty_;
+    std::uniform_real_distribution<double> price_;
+};
+
+}  // namespace
+
+void generate_messages(RawMsg *out, size_t count, const ProducerConfig &cfg) {
+    ContentGenerator gen(cfg);
+    MessageBatch batch;
+    for (size_t i = 0; i < count; i += MessageBatch::kSize) {
+        gen.fill(batch);
+        const size_t n = std::min(count - i, MessageBatch::kSize);
+        for (size_t j = 0; j < n; ++j) {
+            RawMsg &m = out[i + j];
+            m.seq = i + j + 1;
+            m.t_sent_ns = 0;
+            m.symbol_id = batch.symbol[j];
+            m.size = batch.size[j];
+            m.price = batch.price[j];
+        }
+    }
+}
+
 void producer_thread_func(SPSCQueue<RawMsg> &q, std::atomic<bool> &run_flag, uint64_t target_msgs_per_sec) {
-    uint64_t seq = 1;
-    // synthetic price generator
-    std::mt19937_64 rng(12345);
-    std::uniform_int_distribution<uint32_t> sym(1, 1000);
-    std::uniform_int_distribution<uint32_t> qty(1, 1000);
-    std::uniform_real_distribution<double> price(100.0, 200.0);
+    ProducerConfig cfg;
+    cfg.target_msgs_per_sec = target_msgs_per_sec;
+    producer_thread_func(q, run_flag, cfg);
+}
 
-    const auto period = (target_msgs_per_sec == 0) ? nanoseconds(0) :
-                        nanoseconds(1'000'000'000ULL / target_msgs_per_sec);
+void producer_thread_func(SPSCQueue<RawMsg> &q, std::atomic<bool> &run_flag, const ProducerConfig &cfg) {
+    if (cfg.perf) cfg.perf->open();
+    uint64_t seq = cfg.index + 1;
+    const uint64_t seq_step = cfg.producers ? cfg.producers : 1;
+    uint64_t sent = 0;
+    // synthetic content, generated a batch at a time or replayed from the corpus
+    ContentGenerator content(cfg);
+    const RawMsg *corpus = cfg.corpus;
+    size_t corpus_pos = 0;
+    // independent stream for A/B line loss so message content does not depend on it
+    std::mt19937_64 line_rng(54321 + cfg.index);
+    std::uniform_int_distribution<uint32_t> ppm(0, 999'999);
+
+    const uint64_t period_ns = cfg.target_msgs_per_sec ? 1'000'000'000ULL / cfg.target_msgs_per_sec : 0;
+    // intended-time stamping needs a fixed schedule
+    PacingMode mode = cfg.pacing;
+    if (cfg.stamp_intended && mode == PacingMode::Sleep) mode = PacingMode::Absolute;
+    Pacer pacer(period_ns, mode, cfg.spin_ns, Pacer::now_ns(), cfg.traffic, cfg.poisson,
+                0x5DEECE66DULL + cfg.index);
+    PacingStats *ps = cfg.pacing_stats;
+    GeneratorStats *gs = cfg.generator_stats;
+
+    MessageBatch batch;
+    size_t next = MessageBatch::kSize;
+    auto refill = [&] {
+        const uint64_t t0 = gs ? Pacer::now_ns() : 0;
+        content.fill(batch);
+        if (gs) {
+            gs->ns += Pacer::now_ns() - t0;
+            gs->messages += MessageBatch::kSize;
+        }
+        next = 0;
+    };
 
     while (run_flag.load(std::memory_order_relaxed)) {
         RawMsg m;
-        m.seq = seq++;
-        m.t_sent_ns = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
-        m.symbol_id = sym(rng);
-        m.size = qty(rng);
-        m.price = price(rng);
-        // busy spin until push succeeds (simple backpressure)
-        while (!q.try_push(m)) {
-            // brief pause to avoid burning 100% CPU if full
-            std::this_thread::sleep_for(std::chrono::microseconds(1));
-        }
-        if (period.count() > 0) std::this_thread::sleep_for(period);
+        m.seq = seq;
+        seq += seq_step;
+        const uint64_t slot = pacer.wait();
+        const uint64_t t_generate = Pacer::now_ns();
+        const uint64_t late_ns = t_generate > slot ? t_generate - slot : 0;
+        uint64_t stall_ns = 0;
+        uint64_t wait_ns = 0;  // time spent waiting for queue space
+        if (cfg.stamp_intended) {
+            m.t_sent_ns = slot;
+            if (period_ns && late_ns >= period_ns) stall_ns = late_ns;  // a catch-up send, not pacing jitter
+        } else {
+            m.t_sent_ns = t_generate;
+        }
+        if (ps) {
+            if (ps->sent) {
+                ps->intervals.record(t_generate - ps->last_ns);
+            } else {
+                ps->first_ns = t_generate;
+                ps->first_slot_ns = slot;
+            }
+            if (pacer.scheduled()) {
+                ps->lateness.record(late_ns);
+                if (late_ns >= period_ns) ++ps->catch_up;
+                ps->last_slot_ns = slot;
+            }
+            ps->last_ns = t_generate;
+            ++ps->sent;
+        }
+        if (corpus) {
+            const RawMsg &c = corpus[corpus_pos];
+            if (++corpus_pos == cfg.corpus_size) corpus_pos = 0;
+            m.symbol_id = c.symbol_id;
+            m.size = c.size;
+            m.price = c.price;
+        } else {
+            if (next == MessageBatch::kSize) refill();
+            m.symbol_id = batch.symbol[next];
+            m.size = batch.size[next];
+            m.price = batch.price[next];
+            ++next;
+        }
+        if (cfg.tracer && cfg.tracer->sampled(m.seq)) {
+            cfg.tracer->begin(m.seq, t_generate,
+                              duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+        }
+        if (!cfg.shards.empty()) {
+            wait_ns += publish(*cfg.shards[m.symbol_id % cfg.shards.size()], m, run_flag);
+        } else if (!cfg.line_b) {
+            wait_ns += publish(q, m, run_flag);
+        } else {
+            bool drop_a = ppm(line_rng) < cfg.line_loss_ppm;
+            bool drop_b = ppm(line_rng) < cfg.line_loss_ppm;
+            bool b_first = line_rng() & 1;
+            if (b_first && !drop_b) wait_ns += publish(*cfg.line_b, m, run_flag);
+            if (!drop_a) wait_ns += publish(q, m, run_flag);
+            if (!b_first && !drop_b) wait_ns += publish(*cfg.line_b, m, run_flag);
+        }
+        // the gap the traffic profile has in effect now, not the base period:
+        // during a 10x burst a stall hides 10x as many sends
+        const uint64_t gap_ns = stall_ns || wait_ns ? pacer.mean_gap_ns() : 0;
+        if (cfg.skip_stalled && gap_ns && wait_ns >= gap_ns) pacer.skip(wait_ns / gap_ns * gap_ns);
+        stall_ns += wait_ns;
+        if (stall_ns && cfg.stalls) cfg.stalls->record(m.seq, stall_ns, gap_ns);
+        if (cfg.flight) {
+            cfg.flight->record(FlightEvent::Send, m.seq, 0, t_generate);
+            if (wait_ns) {
+                const uint64_t t_end = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+                cfg.flight->record(FlightEvent::StallBegin, m.seq, 0, t_end - wait_ns);
+                cfg.flight->record(FlightEvent::StallEnd, m.seq, flight_arg(wait_ns), t_end);
+            }
+        }
+        if (cfg.produced) cfg.produced->store(++sent, std::memory_order_relaxed);
     }
 }
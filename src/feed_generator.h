@@ -3,7 +3,17 @@
 #include <cstdint>
 #include <cstddef>
 #include <atomic>
+#include <vector>
 #include "spsc_ringbuffer.h"
+#include "pacer.h"
+
+class StageTracer;
+class StallRing;
+class PerfCounters;
+class FlightRing;
+class SymbolSampler;
+class QuoteModel;
+struct GeneratorStats;
 
 /**
  * @file feed_generator.h
@@ -39,9 +49,9 @@
 struct RawMsg {
     uint64_t seq;        ///< Monotonic sequence number for message ordering
     uint64_t t_sent_ns;  ///< Send timestamp (nanoseconds since Unix epoch)
-    uint32_t symbol_id;  ///< Instrument identifier (1-1000 range)
-    uint32_t size;       ///< Order/trade size (1-1000 range)
-    double   price;      ///< Price level (100.0-200.0 range for synthetic data)
+    uint32_t symbol_id;  ///< Instrument identifier (1-1000 range by default)
+    uint32_t size;       ///< Order/trade size (1-1000 range, or whole lots with random-walk quotes)
+    double   price;      ///< Price level (100.0-200.0 uniform for synthetic data, or a bid/ask on the tick grid)
 };
 #pragma pack(pop)
 
@@ -49,6 +59,9 @@ struct RawMsg {
 static_assert(sizeof(RawMsg) == 32, "RawMsg must be exactly 32 bytes for optimal performance");
 static_assert(alignof(RawMsg) <= 8, "RawMsg alignment must not exceed 8 bytes");
 
+/// @brief Synthetic symbol ids are drawn from 1..kSymbolCount unless a SymbolSampler sets the universe
+inline constexpr uint32_t kSymbolCount = 1000;
+
 /**
  * @brief Producer thread function for generating synthetic market data
  * 
@@ -92,3 +105,138 @@ static_assert(alignof(RawMsg) <= 8, "RawMsg alignment must not exceed 8 bytes");
 void producer_thread_func(SPSCQueue<RawMsg> &q, 
                          std::atomic<bool> &run_flag, 
                          uint64_t target_msgs_per_sec);
+
+/**
+ * @struct ProducerConfig
+ * @brief Optional producer settings beyond the target rate
+ *
+ * A default-constructed config reproduces the single-line behavior of the
+ * three-argument producer_thread_func overload.
+ */
+struct ProducerConfig {
+    uint64_t target_msgs_per_sec = 0;     ///< Target message rate (0 = unlimited)
+    SPSCQueue<RawMsg> *line_b = nullptr;  ///< Redundant B line (nullptr = single line)
+    uint32_t line_loss_ppm = 0;           ///< Per-line copy loss rate in parts per million
+    std::atomic<uint64_t> *produced = nullptr;  ///< Messages generated so far (monitoring, optional)
+    bool stamp_intended = false;          ///< Stamp t_sent_ns with the scheduled send time
+    bool skip_stalled = false;            ///< Drop the sends due while waiting for queue space (back-fill)
+    StageTracer *tracer = nullptr;        ///< Stamps Generate/Enqueue of sampled messages (optional)
+    std::vector<SPSCQueue<RawMsg> *> shards;  ///< Consumer shard queues, routed by symbol (empty = q only)
+    StallRing *stalls = nullptr;          ///< Records per-message send stalls (optional)
+    PerfCounters *perf = nullptr;         ///< Opened for the producer thread on start (optional)
+    FlightRing *flight = nullptr;         ///< Flight recorder ring: sends and stalls (optional)
+    PacingMode pacing = PacingMode::Spin;  ///< How to wait between messages
+    uint64_t spin_ns = 50'000;            ///< Busy-wait window before each deadline (PacingMode::Spin)
+    PacingStats *pacing_stats = nullptr;  ///< Inter-arrival and lateness histograms (optional)
+    const TrafficProfile *traffic = nullptr;  ///< Rate over time (nullptr = constant target rate)
+    bool poisson = false;                 ///< Exponential gaps around the scheduled rate
+    const SymbolSampler *symbols = nullptr;  ///< Symbol popularity (nullptr = uniform over the symbol range)
+    uint32_t symbol_base = 0;             ///< Added to every symbol id drawn (this producer's range starts after it)
+    uint32_t symbol_range = kSymbolCount; ///< Uniform symbol ids are drawn from 1..symbol_range (plus symbol_base)
+    QuoteModel *quotes = nullptr;         ///< Random-walk prices and sizes (nullptr = independent uniform draws)
+    bool batch_rng = true;                ///< xoshiro256** batches (false = per-message std::mt19937_64 draws)
+    uint64_t seed = 12345;                ///< Seed of the message content
+    GeneratorStats *generator_stats = nullptr;  ///< Time spent generating content (optional)
+    const RawMsg *corpus = nullptr;       ///< Pre-generated content replayed in a loop (nullptr = generate live)
+    size_t corpus_size = 0;               ///< Messages in corpus
+    unsigned index = 0;                   ///< This producer's number, 0..producers-1
+    unsigned producers = 1;               ///< Producers sharing the sequence space
+};
+
+/**
+ * @brief Producer thread function with extended configuration
+ *
+ * Behaves like the three-argument overload. Messages are paced according to
+ * cfg.pacing (see Pacer): message N is due at
+ * start + (N - 1) / target_msgs_per_sec and the producer sends immediately
+ * when behind. By default (PacingMode::Spin) it sleeps until cfg.spin_ns
+ * before each deadline and busy-waits the rest, so sends land on their slot
+ * even when the period is shorter than the sleep granularity;
+ * PacingMode::Absolute only sleeps until the deadline (overshoot is caught
+ * up, so the rate is met on average) and PacingMode::Sleep keeps the old
+ * sleep-one-period behavior.
+ * When cfg.pacing_stats is set, the intervals between sends and the lateness
+ * of each send against its deadline are recorded there. cfg.traffic scales
+ * the rate over time (bursts, an opening ramp, a replayed curve) and
+ * cfg.poisson draws each gap from the exponential distribution with the
+ * scheduled mean, for Poisson arrivals.
+ *
+ * When cfg.line_b is set, every
+ * message is published to both @p q (line A) and cfg.line_b (line B), as an
+ * exchange does on its redundant A/B lines. Each copy is independently
+ * dropped with probability cfg.line_loss_ppm / 1e6 to simulate line loss, and
+ * the line written first alternates randomly so neither line always wins.
+ * Loss decisions use a separate random stream, so message content is
+ * identical to the single-line run for the same sequence number.
+ *
+ * When cfg.stamp_intended is set, t_sent_ns carries the message's deadline
+ * instead of the moment it was built (PacingMode::Sleep is treated as
+ * Absolute, which has a schedule), so time lost to backpressure stalls
+ * shows up as latency of the messages that should have been sent during
+ * the stall (no coordinated omission).
+ *
+ * When cfg.symbols is set, symbol ids are drawn from it (for example
+ * Zipf-skewed over a larger universe) instead of uniformly from
+ * 1..cfg.symbol_range; either way cfg.symbol_base is added, so several
+ * producers can cover disjoint ranges of one universe.
+ *
+ * With several producers (cfg.producers > 1), producer cfg.index numbers
+ * its messages index + 1, index + 1 + producers, ..., so sequence numbers
+ * stay unique across producers but are not contiguous per queue, and
+ * draws its pacing gaps and line losses from its own streams.
+ * cfg.produced counts this producer's messages. When cfg.quotes is set, price and size come from its
+ * per-symbol bid/ask walk (it must cover every symbol id drawn) instead of
+ * independent uniform draws; symbol ids and timing are unaffected.
+ *
+ * Message content is generated MessageBatch::kSize messages at a time from
+ * cfg.seed, by BatchRng (cfg.batch_rng, the default) or by the original
+ * per-message std::mt19937_64 draws, which reproduce earlier feeds exactly.
+ * When cfg.generator_stats is set, the time spent filling each batch
+ * (including symbol sampling and quote updates) is added there. When
+ * cfg.corpus is set, content is instead copied from its cfg.corpus_size
+ * messages in order, wrapping around at the end (see MessageCorpus), and
+ * the producer only numbers, stamps and publishes.
+ *
+ * When cfg.shards is non-empty, each message goes to
+ * cfg.shards[symbol_id % cfg.shards.size()] instead of @p q, so every
+ * instrument is handled by one consumer shard (cannot be combined with
+ * cfg.line_b).
+ *
+ * When cfg.skip_stalled is set, the whole send gaps spent waiting for queue
+ * space (at the rate the traffic profile has in effect, Pacer::mean_gap_ns())
+ * are dropped from the schedule (Pacer::skip()) rather than caught up on
+ * afterwards, so the sends a stall hid are never sent and a consumer that
+ * back-fills them from cfg.stalls counts each exactly once.
+ *
+ * When cfg.stalls is set, every message that was held up - by waiting for
+ * queue space or, with stamp_intended, by running a base period or more
+ * behind its schedule - has the lost time and the mean send gap in effect
+ * recorded under its sequence number; ordinary pacing jitter is not
+ * recorded. When cfg.perf is set,
+ * its counters are opened for this thread before the first message.
+ *
+ * When cfg.produced is set, the number of messages generated so far is
+ * published to it with a relaxed store after every message, for monitoring
+ * threads to sample.
+ *
+ * @param q Queue for line A (or the only line)
+ * @param run_flag Atomic flag to control thread execution
+ * @param cfg Producer configuration
+ */
+void producer_thread_func(SPSCQueue<RawMsg> &q,
+                          std::atomic<bool> &run_flag,
+                          const ProducerConfig &cfg);
+
+/**
+ * @brief Fills @p out with the content the producer would generate
+ *
+ * Uses the content settings of @p cfg (seed, batch_rng, symbols, quotes), so
+ * a pre-generated corpus holds the same symbols, sizes and prices as a live
+ * run with the same options. Messages are numbered from 1 and t_sent_ns is
+ * left 0. Advances cfg.quotes, if set.
+ *
+ * @param out Destination of @p count messages
+ * @param count Number of messages
+ * @param cfg Content settings
+ */
+void generate_messages(RawMsg *out, size_t count, const ProducerConfig &cfg);
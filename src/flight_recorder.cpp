@@ -0,0 +1,69 @@
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+bool FlightRecorder::trigger(FlightTrigger why, uint64_t seq, uint64_t value, uint64_t t_ns) noexcept {
+    if (taken_.load(std::memory_order_relaxed) >= max_dumps_) return false;
+    uint32_t expected = Idle;
+    if (!state_.compare_exchange_strong(expected, Capturing, std::memory_order_acquire)) return false;
+    for (size_t i = 0; i < rings_.size(); ++i) {
+        pending_[i].dropped = rings_[i]->snapshot(pending_[i].records);
+    }
+    header_ = FlightDumpHeader{};
+    header_.threads = static_cast<uint32_t>(rings_.size());
+    header_.trigger_t_ns = t_ns;
+    header_.trigger_seq = seq;
+    header_.trigger_value = value;
+    header_.trigger = static_cast<uint32_t>(why);
+    taken_.fetch_add(1, std::memory_order_relaxed);
+    state_.store(Ready, std::memory_order_release);
+    return true;
+}
+
+std::string FlightRecorder::write_pending() {
+    if (state_.load(std::memory_order_acquire) != Ready) return {};
+    std::string path = prefix_ + "-" + std::to_string(++written_) + ".bin";
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+    for (size_t i = 0; i < rings_.size(); ++i) {
+        FlightThreadHeader th;
+        std::strncpy(th.name, rings_[i]->name().c_str(), sizeof(th.name) - 1);
+        th.record_count = pending_[i].records.size();
+        th.dropped = pending_[i].dropped;
+        out.write(reinterpret_cast<const char *>(&th), sizeof(th));
+        out.write(reinterpret_cast<const char *>(pending_[i].records.data()),
+                  static_cast<std::streamsize>(pending_[i].records.size() * sizeof(FlightRecord)));
+    }
+    state_.store(Idle, std::memory_order_release);
+    if (!out) throw std::runtime_error("cannot write flight recorder dump " + path);
+    return path;
+}
+
+FlightDump read_flight_dump(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    FlightDump d;
+    if (!in.read(reinterpret_cast<char *>(&d.header), sizeof(d.header)) || d.header.magic != kFlightMagic) {
+        throw std::runtime_error(path + " is not a flight recorder dump");
+    }
+    if (d.header.version != kFlightVersion) {
+        throw std::runtime_error(path + " has dump version " + std::to_string(d.header.version) + ", expected " +
+                                 std::to_string(kFlightVersion));
+    }
+    for (uint32_t t = 0; t < d.header.threads; ++t) {
+        FlightThreadHeader th;
+        if (!in.read(reinterpret_cast<char *>(&th), sizeof(th))) throw std::runtime_error(path + " is truncated");
+        th.name[sizeof(th.name) - 1] = '\0';
+        if (th.record_count > (uint64_t{1} << 28)) throw std::runtime_error(path + " is corrupt");
+        size_t n = d.records.size();
+        d.records.resize(n + th.record_count);
+        if (!in.read(reinterpret_cast<char *>(d.records.data() + n),
+                     static_cast<std::streamsize>(th.record_count * sizeof(FlightRecord)))) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        d.threads.push_back(th);
+    }
+    return d;
+}
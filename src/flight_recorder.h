@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file flight_recorder.h
+ * @brief Always-on per-thread event rings, dumped when an anomaly fires
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Every pipeline thread appends compact events (send, pop, batch, stall,
+ * gap, slow message) to its own ring: three relaxed stores and a release
+ * store of the position, a few ns per event. When a trigger fires - a
+ * latency over the threshold, a sequence gap or SIGUSR1 - the last events of
+ * every ring are copied into preallocated buffers and written to a file by
+ * a non-hot thread. `ffp-trace` turns a dump into a timeline.
+ *
+ * Dump file layout (little-endian, native struct packing):
+ *   FlightDumpHeader, then per ring: FlightThreadHeader followed by
+ *   record_count FlightRecord entries, oldest first.
+ */
+
+/**
+ * @enum FlightEvent
+ * @brief Event kinds (stable on disk)
+ */
+enum class FlightEvent : uint16_t {
+    Send = 1,    ///< Producer published seq
+    StallBegin,  ///< Producer found the queue full (arg: none)
+    StallEnd,    ///< Producer got space again (arg: stall in ns, saturated)
+    Pop,         ///< Consumer dequeued seq (arg: position in the current batch)
+    Batch,       ///< Consumer found the queue empty after a batch (arg: batch size)
+    Gap,         ///< Consumer saw seq after a gap (arg: missing sequences)
+    Slow         ///< Consumer delivered seq above the latency trigger (arg: latency in ns, saturated)
+};
+
+/**
+ * @enum FlightTrigger
+ * @brief Why a dump was taken
+ */
+enum class FlightTrigger : uint32_t {
+    Latency = 1,  ///< A latency exceeded the threshold
+    Gap,          ///< A sequence gap was seen
+    Signal        ///< SIGUSR1 (or another external request)
+};
+
+/// @brief Short event name for timelines
+inline const char *flight_event_name(uint16_t e) noexcept {
+    static const char *const names[] = {"?", "send", "stall-begin", "stall-end", "pop", "batch", "gap", "slow"};
+    return e < sizeof(names) / sizeof(names[0]) ? names[e] : "?";
+}
+
+/// @brief Clamps an event argument to 32 bits
+inline uint32_t flight_arg(uint64_t v) noexcept {
+    return v > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(v);
+}
+
+/// @brief Short trigger name
+inline const char *flight_trigger_name(uint32_t t) noexcept {
+    static const char *const names[] = {"?", "latency", "gap", "signal"};
+    return t < sizeof(names) / sizeof(names[0]) ? names[t] : "?";
+}
+
+/// @brief File identifier ("FFPFLGHT")
+inline constexpr uint64_t kFlightMagic = 0x544847494C465046ULL;
+
+/// @brief Dump layout version
+inline constexpr uint32_t kFlightVersion = 1;
+
+/**
+ * @struct FlightRecord
+ * @brief One event as stored in a dump
+ */
+struct FlightRecord {
+    uint64_t t_ns;   ///< Steady-clock time
+    uint64_t seq;    ///< Message sequence number (0 if none)
+    uint32_t arg;    ///< Event-specific value
+    uint16_t event;  ///< FlightEvent
+    uint16_t thread; ///< Ring index
+};
+static_assert(sizeof(FlightRecord) == 24, "FlightRecord is part of the dump format");
+
+/**
+ * @struct FlightDumpHeader
+ * @brief Start of a dump file
+ */
+struct FlightDumpHeader {
+    uint64_t magic = kFlightMagic;
+    uint32_t version = kFlightVersion;
+    uint32_t threads = 0;       ///< Ring sections that follow
+    uint64_t trigger_t_ns = 0;  ///< When the trigger fired
+    uint64_t trigger_seq = 0;   ///< Message that fired it (0 for signals)
+    uint64_t trigger_value = 0; ///< Latency or gap size
+    uint32_t trigger = 0;       ///< FlightTrigger
+    uint32_t reserved = 0;
+};
+
+/**
+ * @struct FlightThreadHeader
+ * @brief Start of one ring's section in a dump
+ */
+struct FlightThreadHeader {
+    char name[16] = {};         ///< Thread name, e.g. "consumer0"
+    uint64_t record_count = 0;  ///< Records that follow
+    uint64_t dropped = 0;       ///< Events older than the ring (overwritten)
+};
+
+/**
+ * @class FlightRing
+ * @brief Single-writer ring of the most recent events of one thread
+ *
+ * Slots are relaxed atomics, so a snapshot taken from another thread while
+ * the owner keeps writing is race-free; records overwritten during the copy
+ * are detected through the position and discarded.
+ */
+class FlightRing {
+public:
+    /**
+     * @param id Ring index (stored in every record)
+     * @param name Thread name (at most 15 characters are kept)
+     * @param size Number of events kept (power of two)
+     * @throws std::invalid_argument if size is not a power of two
+     */
+    FlightRing(uint16_t id, std::string name, size_t size)
+        : id_(id), name_(std::move(name)), mask_(size - 1), slots_(std::make_unique<Slot[]>(size)) {
+        if (!std::has_single_bit(size)) throw std::invalid_argument("flight ring size must be a power of two");
+    }
+
+    /// @brief Appends one event (owner thread only)
+    void record(FlightEvent e, uint64_t seq, uint32_t arg, uint64_t t_ns) noexcept {
+        const uint64_t p = pos_.load(std::memory_order_relaxed);
+        Slot &s = slots_[p & mask_];
+        s.t_ns.store(t_ns, std::memory_order_relaxed);
+        s.seq.store(seq, std::memory_order_relaxed);
+        s.meta.store(uint64_t{arg} | uint64_t{static_cast<uint16_t>(e)} << 32, std::memory_order_relaxed);
+        pos_.store(p + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the events still in the ring, oldest first (any thread)
+     *
+     * @param out Receives the records; capacity is reserved by the caller
+     * @return Events lost because the ring wrapped before the copy
+     */
+    uint64_t snapshot(std::vector<FlightRecord> &out) const noexcept {
+        out.clear();
+        const uint64_t size = mask_ + 1;
+        const uint64_t end = pos_.load(std::memory_order_acquire);
+        uint64_t begin = end > size ? end - size : 0;
+        for (uint64_t i = begin; i < end; ++i) {
+            const Slot &s = slots_[i & mask_];
+            const uint64_t meta = s.meta.load(std::memory_order_relaxed);
+            out.push_back({s.t_ns.load(std::memory_order_relaxed), s.seq.load(std::memory_order_relaxed),
+                           static_cast<uint32_t>(meta), static_cast<uint16_t>(meta >> 32), id_});
+        }
+        // Slots the writer reused while we copied are no longer the events we
+        // meant; it stores index now before advancing pos_, so the slot of
+        // index now - size may be half written as well
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = pos_.load(std::memory_order_relaxed);
+        uint64_t overwritten = now + 1 > size + begin ? std::min<uint64_t>(now + 1 - size - begin, out.size()) : 0;
+        out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(overwritten));
+        return begin + overwritten;
+    }
+
+    const std::string &name() const noexcept { return name_; }
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> t_ns{0};
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> meta{0};  // arg | event << 32
+    };
+
+    uint16_t id_;
+    std::string name_;
+    uint64_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> pos_{0};
+};
+
+/**
+ * @class FlightRecorder
+ * @brief Owns the rings, the trigger rules and the pending dump
+ *
+ * trigger() may be called from any thread, including hot ones: it copies
+ * the rings into buffers allocated up front and returns. The file is
+ * written later by write_pending() on a non-hot thread. One dump is pending
+ * at a time; triggers while one is pending, or after max_dumps, are
+ * ignored.
+ */
+class FlightRecorder {
+public:
+    /**
+     * @param events_per_thread Ring size (power of two)
+     * @param prefix Dump files are named PREFIX-N.bin
+     * @param max_dumps Dumps written at most
+     */
+    FlightRecorder(size_t events_per_thread, std::string prefix, size_t max_dumps)
+        : events_(events_per_thread), prefix_(std::move(prefix)), max_dumps_(max_dumps) {}
+
+    /**
+     * @brief Adds a ring for one thread (before the threads start)
+     *
+     * @throws std::invalid_argument if the ring size is not a power of two
+     */
+    FlightRing &add_ring(const std::string &name) {
+        rings_.push_back(std::make_unique<FlightRing>(static_cast<uint16_t>(rings_.size()), name, events_));
+        pending_.emplace_back();
+        pending_.back().records.reserve(events_);
+        return *rings_.back();
+    }
+
+    /// @brief Dump when a latency exceeds @p ns (0 = never)
+    void set_latency_trigger(uint64_t ns) noexcept { latency_ns_ = ns; }
+    uint64_t latency_trigger() const noexcept { return latency_ns_; }
+
+    /// @brief Dump on sequence gaps
+    void set_gap_trigger(bool on) noexcept { on_gap_ = on; }
+    bool gap_trigger() const noexcept { return on_gap_; }
+
+    /**
+     * @brief Captures every ring if no dump is pending (any thread)
+     *
+     * @return True if a dump was captured
+     */
+    bool trigger(FlightTrigger why, uint64_t seq, uint64_t value, uint64_t t_ns) noexcept;
+
+    /**
+     * @brief Writes the pending dump, if any (non-hot thread)
+     *
+     * @return Path of the file written, or empty if nothing was pending
+     * @throws std::runtime_error if the file cannot be written
+     */
+    std::string write_pending();
+
+    /// @brief Dumps captured so far
+    size_t dumps() const noexcept { return taken_.load(std::memory_order_relaxed); }
+
+private:
+    struct Capture {
+        std::vector<FlightRecord> records;
+        uint64_t dropped = 0;
+    };
+
+    enum State : uint32_t { Idle, Capturing, Ready };
+
+    size_t events_;
+    std::string prefix_;
+    size_t max_dumps_;
+    uint64_t latency_ns_ = 0;
+    bool on_gap_ = false;
+    std::vector<std::unique_ptr<FlightRing>> rings_;
+    std::vector<Capture> pending_;
+    FlightDumpHeader header_;
+    std::atomic<uint32_t> state_{Idle};
+    std::atomic<size_t> taken_{0};
+    size_t written_ = 0;
+};
+
+/**
+ * @struct FlightDump
+ * @brief A dump read back from a file
+ */
+struct FlightDump {
+    FlightDumpHeader header;
+    std::vector<FlightThreadHeader> threads;
+    std::vector<FlightRecord> records;  ///< All rings, in file order
+};
+
+/**
+ * @brief Reads a dump written by FlightRecorder
+ *
+ * @throws std::runtime_error if the file is missing, truncated or of another version
+ */
+FlightDump read_flight_dump(const std::string &path);
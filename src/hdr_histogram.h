@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file hdr_histogram.h
+ * @brief Fixed-memory log-linear latency histogram (HdrHistogram layout)
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Replaces unbounded latency sample vectors with a histogram whose size is
+ * fixed at construction and whose recording cost is constant, so arbitrarily
+ * long runs can be measured with a few hundred kilobytes of memory.
+ */
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear histogram with a configurable number of significant digits
+ *
+ * Values are grouped into power-of-two buckets, each split into linear
+ * sub-buckets. With N significant digits every recorded value is represented
+ * with a relative error below 10^-N, across the whole range from 1 to the
+ * highest trackable value. This is the bucket layout of Gil Tene's
+ * HdrHistogram, reduced to what the benchmark needs.
+ *
+ * Recording is a count-leading-zeros, two shifts and one increment - no
+ * branches on the value distribution and no allocation. Values above the
+ * highest trackable value are clamped into the top bucket (max() still
+ * reports the true maximum).
+ *
+ * Memory: for 3 significant digits and a one-hour range in nanoseconds,
+ * about 33K counters (270 KB).
+ *
+ * @note Not thread-safe. One histogram belongs to one recording thread; read
+ *       it from other threads only after the recorder has been joined.
+ *
+ * Example usage:
+ * @code
+ * LatencyHistogram h(3'600'000'000'000ULL, 3);  // 1 hour in ns, 3 digits
+ * h.record(latency_ns);
+ * uint64_t p99 = h.value_at_quantile(0.99);
+ * @endcode
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Constructs an empty histogram
+     *
+     * @param highest_trackable Largest value tracked at full precision (>= 2)
+     * @param significant_digits Decimal digits of precision (1 to 5)
+     *
+     * @throws std::invalid_argument if either parameter is out of range
+     */
+    explicit LatencyHistogram(uint64_t highest_trackable = 3'600'000'000'000ULL,
+                              int significant_digits = 3) {
+        if (significant_digits < 1 || significant_digits > 5) {
+            throw std::invalid_argument("histogram precision must be 1 to 5 significant digits");
+        }
+        if (highest_trackable < 2) {
+            throw std::invalid_argument("histogram highest trackable value must be >= 2");
+        }
+        uint64_t single_unit_limit = 2;
+        for (int i = 0; i < significant_digits; ++i) single_unit_limit *= 10;
+        int sub_bucket_magnitude = static_cast<int>(std::bit_width(single_unit_limit - 1));
+        sub_bucket_half_magnitude_ = sub_bucket_magnitude - 1;
+        sub_bucket_count_ = uint64_t{1} << sub_bucket_magnitude;
+        sub_bucket_half_count_ = sub_bucket_count_ / 2;
+        sub_bucket_mask_ = sub_bucket_count_ - 1;
+
+        // Smallest bucket count whose top bucket covers highest_trackable
+        int buckets = 1;
+        uint64_t smallest_untrackable = sub_bucket_count_;
+        while (smallest_untrackable <= highest_trackable) {
+            if (smallest_untrackable > (UINT64_MAX >> 1)) {
+                ++buckets;
+                break;
+            }
+            smallest_untrackable <<= 1;
+            ++buckets;
+        }
+        highest_trackable_ = highest_trackable;
+        significant_digits_ = significant_digits;
+        counts_.assign(static_cast<size_t>(buckets + 1) * sub_bucket_half_count_, 0);
+    }
+
+    /**
+     * @brief Records one value
+     *
+     * @param value Value to record (clamped to the highest trackable value)
+     */
+    void record(uint64_t value) noexcept {
+        record_n(value, 1);
+    }
+
+    /**
+     * @brief Records @p n occurrences of a value
+     *
+     * @param value Value to record (clamped to the highest trackable value)
+     * @param n Number of occurrences
+     */
+    void record_n(uint64_t value, uint64_t n) noexcept {
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+        total_ += n;
+        sum_ += static_cast<double>(value) * n;
+        counts_[index_of(std::min(value, highest_trackable_))] += n;
+    }
+
+    /// @brief Most distinct values one record_backfill() call records
+    static constexpr uint64_t kMaxBackfillValues = 1024;
+
+    /**
+     * @brief Back-fills the samples a producer stall hid
+     *
+     * Coordinated-omission correction: a message whose producer waited
+     * @p stall_ns for queue space was delivered with latency @p value, and
+     * the stall_ns / interval messages due during the wait were never sent.
+     * Had they been, they would have been delivered with it, so they are
+     * recorded with latencies value - interval, value - 2 * interval, ...
+     * The measured value itself is not recorded here.
+     *
+     * Call once per stall. Stalls hiding more than kMaxBackfillValues
+     * samples are recorded as that many evenly spaced values with counts
+     * that add up to the hidden samples, so the cost per stall is bounded.
+     *
+     * @param value Measured latency of the message that waited
+     * @param stall_ns Time its producer waited for queue space
+     * @param interval Producer's send period (0 = no correction)
+     */
+    void record_backfill(uint64_t value, uint64_t stall_ns, uint64_t interval) noexcept {
+        if (interval == 0) return;
+        const uint64_t hidden = std::min(stall_ns, value) / interval;
+        const uint64_t steps = std::min(hidden, kMaxBackfillValues);
+        for (uint64_t i = 0; i < steps; ++i) {
+            // samples first..last of the hidden ones, at their middle latency
+            const uint64_t first = i * hidden / steps + 1, last = (i + 1) * hidden / steps;
+            record_n(value - (first + last) / 2 * interval, last - first + 1);
+        }
+    }
+
+    /**
+     * @brief Adds all values recorded in @p other to this histogram
+     *
+     * The merge is exact: counters are added pairwise, so the result equals
+     * a histogram that recorded both streams. Per-thread histograms can
+     * therefore be combined for reporting without averaging percentiles.
+     *
+     * @throws std::invalid_argument if the histograms are configured differently
+     */
+    void merge(const LatencyHistogram &other) {
+        if (other.significant_digits_ != significant_digits_ ||
+            other.highest_trackable_ != highest_trackable_) {
+            throw std::invalid_argument("cannot merge histograms with different configurations");
+        }
+        for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    /// @brief Clears all counts; the configuration is kept
+    void reset() noexcept {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        sum_ = 0.0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+    }
+
+    /// @brief Number of recorded values
+    uint64_t count() const noexcept {
+        return total_;
+    }
+
+    /// @brief Smallest recorded value (0 if empty)
+    uint64_t min() const noexcept {
+        return total_ ? min_ : 0;
+    }
+
+    /// @brief Largest recorded value (0 if empty)
+    uint64_t max() const noexcept {
+        return max_;
+    }
+
+    /// @brief Arithmetic mean of recorded values (0.0 if empty)
+    double mean() const noexcept {
+        return total_ ? sum_ / total_ : 0.0;
+    }
+
+    /// @brief Configured precision in significant decimal digits
+    int significant_digits() const noexcept {
+        return significant_digits_;
+    }
+
+    /// @brief Configured highest trackable value
+    uint64_t highest_trackable() const noexcept {
+        return highest_trackable_;
+    }
+
+    /**
+     * @brief Returns the value at quantile @p q
+     *
+     * Finds the first counter at which the cumulative count reaches
+     * ceil(q * count()) and returns the highest value that counter
+     * represents (capped at max()), i.e. the result is never below the true
+     * quantile and at most one precision step above it.
+     *
+     * @param q Quantile in [0.0, 1.0] (e.g. 0.99 for the 99th percentile)
+     * @return Value at the quantile, or 0 if the histogram is empty
+     *
+     * @note Time complexity: O(number of counters)
+     */
+    uint64_t value_at_quantile(double q) const noexcept {
+        if (total_ == 0) return 0;
+        q = std::clamp(q, 0.0, 1.0);
+        uint64_t target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total_)));
+        if (target == 0) target = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(highest_equivalent(value_at_index(i)), max_);
+            }
+        }
+        return max_;
+    }
+
+    /// @brief Number of counters (for bucket iteration and export)
+    size_t counts_size() const noexcept {
+        return counts_.size();
+    }
+
+    /// @brief Count stored in counter @p i
+    uint64_t count_at_index(size_t i) const noexcept {
+        return counts_[i];
+    }
+
+    /// @brief Lowest value represented by counter @p i
+    uint64_t value_at_index(size_t i) const noexcept {
+        int bucket = static_cast<int>(i >> sub_bucket_half_magnitude_) - 1;
+        uint64_t sub_bucket = (i & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+        if (bucket < 0) {
+            sub_bucket -= sub_bucket_half_count_;
+            bucket = 0;
+        }
+        return sub_bucket << bucket;
+    }
+
+    /// @brief Highest value that shares a counter with @p value
+    uint64_t highest_equivalent(uint64_t value) const noexcept {
+        uint64_t lowest = value_at_index(index_of(value));
+        return lowest + size_of_range(value) - 1;
+    }
+
+private:
+    size_t index_of(uint64_t value) const noexcept {
+        int bucket = bucket_index(value);
+        uint64_t sub_bucket = value >> bucket;
+        return (static_cast<size_t>(bucket + 1) << sub_bucket_half_magnitude_) +
+               (sub_bucket - sub_bucket_half_count_);
+    }
+
+    int bucket_index(uint64_t value) const noexcept {
+        int pow2_ceiling = static_cast<int>(std::bit_width(value | sub_bucket_mask_));
+        return pow2_ceiling - (sub_bucket_half_magnitude_ + 1);
+    }
+
+    uint64_t size_of_range(uint64_t value) const noexcept {
+        return uint64_t{1} << bucket_index(value);
+    }
+
+    std::vector<uint64_t> counts_;     ///< One counter per (bucket, sub-bucket)
+    uint64_t highest_trackable_ = 0;   ///< Values above this are clamped
+    int significant_digits_ = 3;       ///< Configured precision
+    int sub_bucket_half_magnitude_ = 0;  ///< log2(sub_bucket_half_count_)
+    uint64_t sub_bucket_count_ = 0;    ///< Linear sub-buckets per power of two
+    uint64_t sub_bucket_half_count_ = 0;  ///< sub_bucket_count_ / 2
+    uint64_t sub_bucket_mask_ = 0;     ///< sub_bucket_count_ - 1
+    uint64_t total_ = 0;               ///< Number of recorded values
+    double sum_ = 0.0;                 ///< Sum of recorded values (for mean)
+    uint64_t min_ = UINT64_MAX;        ///< Smallest recorded value
+    uint64_t max_ = 0;                 ///< Largest recorded value
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "hdr_histogram.h"
+
+/**
+ * @file interval_recorder.h
+ * @brief Double-buffered per-interval latency histograms
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Lets a reporting thread take a latency histogram per time interval from a
+ * recording thread without locks, so the run can be reported as a time
+ * series (when did tail latency spike?) instead of a single summary.
+ */
+
+/**
+ * @struct IntervalSample
+ * @brief One row of the per-interval time series
+ */
+struct IntervalSample {
+    double t_s = 0.0;        ///< End of the interval, seconds since start
+    double length_s = 0.0;   ///< Interval length in seconds
+    uint64_t produced = 0;   ///< Messages generated during the interval
+    uint64_t consumed = 0;   ///< Messages delivered during the interval
+    uint64_t depth = 0;      ///< Queue depth at the end of the interval
+    uint64_t p50 = 0;        ///< Median latency (ns)
+    uint64_t p90 = 0;        ///< 90th percentile latency (ns)
+    uint64_t p99 = 0;        ///< 99th percentile latency (ns)
+    uint64_t p999 = 0;       ///< 99.9th percentile latency (ns)
+    uint64_t max = 0;        ///< Maximum latency (ns)
+};
+
+/**
+ * @class IntervalRecorder
+ * @brief Two histograms swapped between one writer and one reader
+ *
+ * The writer (consumer thread) records into the active histogram. To close
+ * an interval, the reader (reporter thread) clears the spare histogram and
+ * publishes a flip request; the writer notices the request on its next
+ * record() or poll(), switches to the spare and acknowledges. After the
+ * acknowledgement the reader owns the closed histogram until its next
+ * rotate().
+ *
+ * The writer never blocks or executes a read-modify-write: its added cost is
+ * one relaxed load and a predictable branch per record. Release/acquire on
+ * the request and acknowledgement counters order the reader's clear before
+ * the writer's new records, and the writer's records before the reader's
+ * reads.
+ *
+ * @note Exactly one writer thread and one reader thread.
+ *
+ * Example usage:
+ * @code
+ * IntervalRecorder rec;
+ * // consumer thread:  rec.record(latency_ns);  ... rec.poll() when idle
+ * // reporter thread, once per second:
+ * if (const LatencyHistogram *h = rec.rotate(std::chrono::milliseconds(50))) {
+ *     report(h->value_at_quantile(0.99));
+ * }
+ * @endcode
+ */
+class IntervalRecorder {
+public:
+    /**
+     * @brief Constructs both histograms with the given configuration
+     *
+     * @param highest_trackable Largest value tracked at full precision
+     * @param significant_digits Histogram precision (1 to 5)
+     */
+    explicit IntervalRecorder(uint64_t highest_trackable = 3'600'000'000'000ULL,
+                              int significant_digits = 3)
+        : buffers_{LatencyHistogram(highest_trackable, significant_digits),
+                   LatencyHistogram(highest_trackable, significant_digits)} {}
+
+    IntervalRecorder(const IntervalRecorder &) = delete;
+    IntervalRecorder &operator=(const IntervalRecorder &) = delete;
+
+    /**
+     * @brief Records a value into the current interval (writer thread)
+     */
+    void record(uint64_t value) noexcept {
+        poll();
+        buffers_[active_].record(value);
+    }
+
+    /**
+     * @brief Back-fills the samples a producer stall hid (writer thread)
+     *
+     * @see LatencyHistogram::record_backfill()
+     */
+    void record_backfill(uint64_t value, uint64_t stall_ns, uint64_t interval) noexcept {
+        poll();
+        buffers_[active_].record_backfill(value, stall_ns, interval);
+    }
+
+    /**
+     * @brief Services a pending flip request (writer thread)
+     *
+     * Call while idle so intervals close on time even without traffic.
+     */
+    void poll() noexcept {
+        uint64_t req = requested_.load(std::memory_order_relaxed);
+        if (req != seen_) [[unlikely]] {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            active_ ^= 1;
+            seen_ = req;
+            acked_.store(req, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Closes the current interval and returns its histogram (reader thread)
+     *
+     * @param timeout Longest time to wait for the writer to acknowledge
+     * @return The closed interval's histogram, valid until the next rotate(),
+     *         or nullptr if the writer did not acknowledge in time. The
+     *         request stays pending and the next call waits for it again;
+     *         the histogram it returns then also holds everything recorded
+     *         in between, so a reader that needs aligned intervals retries
+     *         rather than moving on to the next interval.
+     */
+    const LatencyHistogram *rotate(std::chrono::nanoseconds timeout) {
+        if (pending_ == 0) {
+            buffers_[spare_].reset();
+            pending_ = ++epoch_;
+            requested_.store(pending_, std::memory_order_release);
+        }
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (acked_.load(std::memory_order_acquire) != pending_) {
+            if (std::chrono::steady_clock::now() >= deadline) return nullptr;
+            std::this_thread::yield();
+        }
+        pending_ = 0;
+        unsigned closed = spare_ ^ 1;
+        spare_ = closed;
+        return &buffers_[closed];
+    }
+
+    /**
+     * @brief Returns the interval still being recorded
+     *
+     * @warning Call only after the writer thread has been joined.
+     */
+    const LatencyHistogram &current() const noexcept {
+        return buffers_[active_];
+    }
+
+private:
+    LatencyHistogram buffers_[2];                       ///< Active and spare histograms
+    alignas(64) std::atomic<uint64_t> requested_{0};    ///< Flip requests (reader -> writer)
+    alignas(64) std::atomic<uint64_t> acked_{0};        ///< Flip acknowledgements (writer -> reader)
+    alignas(64) unsigned active_ = 0;                   ///< Writer: histogram being recorded
+    uint64_t seen_ = 0;                                 ///< Writer: last request serviced
+    alignas(64) unsigned spare_ = 1;                    ///< Reader: histogram the writer moves to next
+    uint64_t epoch_ = 0;                                ///< Reader: last request number issued
+    uint64_t pending_ = 0;                              ///< Reader: unacknowledged request (0 = none)
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file latency_sampler.h
+ * @brief Bounded raw latency samples: first N, uniform reservoir or per second
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Keeping only the first N samples describes the start of a run - cold
+ * caches and warm-up - and says nothing about its end. A reservoir keeps a
+ * uniform random sample of the whole run in the same memory, and the
+ * stratified mode keeps K samples of every second so a slow second is
+ * represented even when it delivered few messages.
+ *
+ * Reservoirs use Li's Algorithm L: after the reservoir fills, the index of
+ * the next replacement is drawn directly, so the typical message costs one
+ * compare and the RNG runs O(k log(n/k)) times over n messages.
+ */
+
+/**
+ * @class LatencySampler
+ * @brief Fixed-memory raw sample recorder
+ *
+ * @note Not thread-safe. One sampler belongs to one consumer thread; shard
+ *       samplers are combined with merge_samples().
+ */
+class LatencySampler {
+public:
+    /**
+     * @enum Mode
+     * @brief Which samples are kept
+     */
+    enum class Mode {
+        First,       ///< The first capacity samples
+        Reservoir,   ///< Uniform random sample of the whole run
+        Stratified   ///< Uniform random sample of each stratum (time slice)
+    };
+
+    /**
+     * @param mode Sampling mode
+     * @param per_stratum Samples kept per stratum (the whole capacity unless stratified)
+     * @param strata Number of time slices (1 unless stratified); late samples go to the last
+     * @param t_start_ns Start of the first slice (steady clock)
+     * @param stratum_ns Length of one slice
+     * @param seed RNG seed (give each shard its own)
+     * @throws std::invalid_argument if per_stratum or strata is 0
+     */
+    LatencySampler(Mode mode, size_t per_stratum, size_t strata = 1, uint64_t t_start_ns = 0,
+                   uint64_t stratum_ns = 1'000'000'000ULL, uint64_t seed = 0x9E3779B97F4A7C15ULL)
+        : mode_(mode), k_(per_stratum), strata_(mode == Mode::Stratified ? strata : 1),
+          stratum_ns_(stratum_ns), stratum_end_(t_start_ns + stratum_ns), rng_(seed),
+          state_(strata_), samples_(k_ * strata_) {
+        if (per_stratum == 0 || strata == 0) throw std::invalid_argument("sampler capacity must be positive");
+    }
+
+    /**
+     * @brief Offers one latency received at @p t_ns
+     *
+     * @param latency_ns Latency sample
+     * @param t_ns Receive time (only used when stratified)
+     */
+    void offer(uint64_t latency_ns, uint64_t t_ns) noexcept {
+        if (mode_ == Mode::Stratified) {
+            while (t_ns >= stratum_end_ && cur_ + 1 < strata_) {
+                ++cur_;
+                stratum_end_ += stratum_ns_;
+            }
+        }
+        Stratum &st = state_[cur_];
+        const uint64_t i = st.seen++;
+        if (i < k_) {
+            samples_[cur_ * k_ + i] = latency_ns;
+            if (i + 1 == k_ && mode_ != Mode::First) {
+                st.w = std::exp(std::log(uniform()) / k_);
+                skip(st, i);
+            }
+        } else if (i == st.next) [[unlikely]] {
+            samples_[cur_ * k_ + rng_() % k_] = latency_ns;
+            st.w *= std::exp(std::log(uniform()) / k_);
+            skip(st, i);
+        }
+    }
+
+    /// @brief Kept samples, stratum by stratum
+    std::vector<uint64_t> samples() const {
+        std::vector<uint64_t> out;
+        for (size_t s = 0; s < strata_; ++s) {
+            out.insert(out.end(), samples_.begin() + s * k_, samples_.begin() + s * k_ + kept(s));
+        }
+        return out;
+    }
+
+    /// @brief Samples offered to stratum @p s
+    uint64_t seen(size_t s) const noexcept { return state_[s].seen; }
+
+    /// @brief Samples kept in stratum @p s
+    size_t kept(size_t s) const noexcept { return static_cast<size_t>(std::min<uint64_t>(state_[s].seen, k_)); }
+
+    /// @brief Kept samples of stratum @p s
+    const uint64_t *stratum(size_t s) const noexcept { return samples_.data() + s * k_; }
+
+    Mode mode() const noexcept { return mode_; }
+    size_t strata() const noexcept { return strata_; }
+    size_t per_stratum() const noexcept { return k_; }
+
+private:
+    struct Stratum {
+        uint64_t seen = 0;           // samples offered
+        uint64_t next = UINT64_MAX;  // index of the next replacement
+        double w = 0.0;              // Algorithm L running maximum
+    };
+
+    // xorshift64*: fast and plenty for choosing sample slots
+    struct Rng {
+        explicit Rng(uint64_t seed) : s(seed ? seed : 1) {}
+        uint64_t operator()() noexcept {
+            s ^= s >> 12;
+            s ^= s << 25;
+            s ^= s >> 27;
+            return s * 0x2545F4914F6CDD1DULL;
+        }
+        uint64_t s;
+    };
+
+    // Uniform in (0, 1)
+    double uniform() noexcept {
+        return (static_cast<double>(rng_() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+
+    // Draws the gap to the next replacement after index i
+    void skip(Stratum &st, uint64_t i) noexcept {
+        const double gap = std::floor(std::log(uniform()) / std::log1p(-st.w));
+        st.next = gap < 1e18 ? i + 1 + static_cast<uint64_t>(gap) : UINT64_MAX;
+    }
+
+    Mode mode_;
+    size_t k_;
+    size_t strata_;
+    uint64_t stratum_ns_;
+    uint64_t stratum_end_;
+    size_t cur_ = 0;
+    Rng rng_;
+    std::vector<Stratum> state_;
+    std::vector<uint64_t> samples_;
+};
+
+/**
+ * @brief Combines shard samplers into one sample of the whole stream
+ *
+ * Shards that saw more messages keep proportionally more samples: in each
+ * stratum every shard is randomly thinned to the lowest kept/seen ratio of
+ * any shard, so the result is still uniform (per stratum when stratified). First-N samplers are simply concatenated.
+ *
+ * @param parts Samplers with identical mode and stratum layout
+ */
+inline std::vector<uint64_t> merge_samples(const std::vector<const LatencySampler *> &parts) {
+    std::vector<uint64_t> out;
+    if (parts.empty()) return out;
+    if (parts[0]->mode() == LatencySampler::Mode::First) {
+        for (const LatencySampler *p : parts) {
+            std::vector<uint64_t> s = p->samples();
+            out.insert(out.end(), s.begin(), s.end());
+        }
+        return out;
+    }
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    for (size_t s = 0; s < parts[0]->strata(); ++s) {
+        // Lowest kept/seen fraction across shards
+        double rate = 1.0;
+        for (const LatencySampler *p : parts) {
+            if (p->seen(s)) rate = std::min(rate, static_cast<double>(p->kept(s)) / p->seen(s));
+        }
+        for (const LatencySampler *p : parts) {
+            std::vector<uint64_t> v(p->stratum(s), p->stratum(s) + p->kept(s));
+            size_t keep = std::min(v.size(), static_cast<size_t>(std::llround(p->seen(s) * rate)));
+            // Partial Fisher-Yates: a uniform subset of size keep
+            for (size_t i = 0; i < keep; ++i) {
+                rng ^= rng >> 12;
+                rng ^= rng << 25;
+                rng ^= rng >> 27;
+                std::swap(v[i], v[i + (rng * 0x2545F4914F6CDD1DULL) % (v.size() - i)]);
+            }
+            out.insert(out.end(), v.begin(), v.begin() + keep);
+        }
+    }
+    return out;
+}
@@ -10,12 +10,25 @@
  * and throughput characteristics of a producer-consumer architecture commonly
  * used in financial trading systems.
  * 
- * The application creates two threads:
+ * The application creates two main threads:
  * - Producer: Generates synthetic market data at configurable rates
  * - Consumer: Processes messages and collects latency statistics
+ *   (--shards=N runs N consumers, each fed by its own queue and recording
+ *   into its own histograms, merged exactly for the report; --producers=N
+ *   runs N producers over disjoint symbol ranges, each with its own queue
+ *   into every consumer)
  * 
  * Command line arguments:
- *   ./fast-feed-parser [msgs_per_sec] [total_seconds] [buffer_pow2]
+ *   ./fast-feed-parser [msgs_per_sec] [total_seconds] [buffer_pow2] [--options]
+ * 
+ * With --ab the producer publishes every message on two redundant lines and
+ * an arbitration thread merges them before the consumer.
+ *
+ * With --co=intended latency is measured from each message's scheduled send
+ * time rather than the moment the producer got around to sending it;
+ * --co=backfill instead adds the sends a producer's wait for queue space hid
+ * to the recorders. Either keeps a slow consumer from hiding its own tail
+ * (coordinated omission); they correct the same stalls, so only one is used.
  * 
  * Example:
  *   ./fast-feed-parser 1000000 10 17
@@ -24,8 +37,23 @@
 
 #include "spsc_ringbuffer.h"
 #include "feed_generator.h"
+#include "arbiter.h"
 #include "parser.h"
 #include "util.h"
+#include "interval_recorder.h"
+#include "stage_trace.h"
+#include "shm_metrics.h"
+#include "prometheus_exporter.h"
+#include "report.h"
+#include "outlier_tracker.h"
+#include "perf_counters.h"
+#include "latency_sampler.h"
+#include "symbol_stats.h"
+#include "flight_recorder.h"
+#include "symbol_sampler.h"
+#include "quote_model.h"
+#include "batch_rng.h"
+#include "corpus.h"
 
 #include <thread>
 #include <chrono>
@@ -35,6 +63,14 @@
 #include <vector>
 #include <iomanip>
 #include <stdexcept>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <bit>
+#include <sstream>
+#include <optional>
 
 /**
  * @brief Global flag for graceful shutdown coordination
@@ -60,11 +96,23 @@ void sigint_handler(int signal) {
     g_run.store(false, std::memory_order_release);
 }
 
+// Per-symbol histograms per shard (1.25 KB each); larger universes share
+// them in order of first appearance
+constexpr size_t kSymbolHistograms = 16384;
+
+// Set by SIGUSR1: take a flight recorder dump
+std::atomic<bool> g_flight_signal{false};
+
+void sigusr1_handler(int signal) {
+    (void)signal;
+    g_flight_signal.store(true, std::memory_order_relaxed);
+}
+
 /**
  * @brief Prints usage information and command line argument help
  */
 void print_usage(const char* program_name) {
-    std::cout << "\nUsage: " << program_name << " [msgs_per_sec] [total_seconds] [buffer_pow2]\n\n";
+    std::cout << "\nUsage: " << program_name << " [msgs_per_sec] [total_seconds] [buffer_pow2] [options]\n\n";
     std::cout << "Arguments:\n";
     std::cout << "  msgs_per_sec  - Target message rate (default: 500000)\n";
     std::cout << "                  Range: 1 to 10,000,000\n";
@@ -72,10 +120,552 @@ void print_usage(const char* program_name) {
     std::cout << "                  Range: 1 to 3600\n";
     std::cout << "  buffer_pow2   - Buffer size as power of 2 (default: 16 = 65536)\n";
     std::cout << "                  Range: 10 to 24 (1K to 16M elements)\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --ab                  Publish on redundant A/B lines and arbitrate them\n";
+    std::cout << "  --line-loss-ppm=N     Per-line copy loss with --ab, parts per million (default: 0)\n";
+    std::cout << "  --arb-window=N        Arbitration window as power of 2 (default: 12 = 4096 seqs)\n";
+    std::cout << "  --reorder=N           Reorder window in the consumer, 2^N slots (default: off)\n";
+    std::cout << "  --reorder-timeout-us=N  Longest hold before a gap is skipped (default: 100)\n";
+    std::cout << "  --hdr-digits=N        Latency histogram precision, significant digits 1-5 (default: 3)\n";
+    std::cout << "  --raw-samples=N       Also keep N raw latency samples for exact percentiles\n";
+    std::cout << "  --sampling=MODE       Raw samples kept: first, reservoir (uniform) or stratified\n";
+    std::cout << "                        (equal share per second) (default: first)\n";
+    std::cout << "  --recorder=R          Latency recorder: hdr, ddsketch or both (default: hdr)\n";
+    std::cout << "  --sketch-accuracy=P   DDSketch relative accuracy in percent (default: 1)\n";
+    std::cout << "  --interval-ms=N       Reporting interval for the time series (default: 1000)\n";
+    std::cout << "  --co=MODE             Coordinated-omission correction: off, intended (latency from the\n";
+    std::cout << "                        schedule) or backfill (samples hidden by queue-full stalls) (default: off)\n";
+    std::cout << "  --pacing=MODE         Send pacing: spin (default; deadlines, busy-wait before each, catch up\n";
+    std::cout << "                        when behind; absolute on a single CPU), absolute (sleep until each\n";
+    std::cout << "                        deadline) or sleep (per message)\n";
+    std::cout << "  --traffic=SHAPE       Rate over time: constant (default), bursts[:MULT:ON_US:EVERY_MS],\n";
+    std::cout << "                        open[:MULT:SECONDS] or curve:PATH (\"t_ms multiplier\" lines, looped)\n";
+    std::cout << "  --arrivals=MODE       uniform (default) or poisson (exponential gaps around the rate)\n";
+    std::cout << "  --universe=N          Symbol ids 1..N (default: 1000, at most 1048576)\n";
+    std::cout << "  --zipf=S              Zipf popularity skew of the symbols (default: 0, uniform; ~1 is typical)\n";
+    std::cout << "  --prices=MODE         uniform (default; independent draws) or walk (per-symbol bid/ask\n";
+    std::cout << "                        random walk on a tick grid, heavy-tailed lot sizes)\n";
+    std::cout << "  --rng=GEN             Message content generator: batch (default; xoshiro256**, AVX2 when\n";
+    std::cout << "                        available) or mt19937 (the original per-message draws)\n";
+    std::cout << "  --seed=N              Seed of the message content (default: 12345)\n";
+    std::cout << "  --corpus=N            Pre-generate N million messages in huge pages and replay them in a\n";
+    std::cout << "                        loop, keeping content generation out of the producer (default: off)\n";
+    std::cout << "  --corpus-file=PATH    Replay a corpus file instead (see --corpus-save)\n";
+    std::cout << "  --corpus-save=PATH    Write the corpus to PATH before the run\n";
+    std::cout << "  --spin-us=N           Busy-wait window before each deadline with --pacing=spin (default: 50)\n";
+    std::cout << "  --trace-every=N       Time every Nth message at each pipeline stage, N a power of 2\n";
+    std::cout << "                        (default: off)\n";
+    std::cout << "  --shm[=NAME]          Publish live metrics in shared memory for ffp-stat\n";
+    std::cout << "                        (default name: " << kMetricsDefaultName << ")\n";
+    std::cout << "  --prometheus[=PORT]   Serve Prometheus metrics on 127.0.0.1:PORT/metrics (default: 9464)\n";
+    std::cout << "  --shards=N            Consumer shards, messages routed by symbol (default: 1)\n";
+    std::cout << "  --producers=N         Producer threads, each with a slice of the symbols, its own seeds and\n";
+    std::cout << "                        its own queue into every shard; they share the rate (default: 1)\n";
+    std::cout << "  --outliers=K          Keep the K worst latencies with queue depth, producer stall and CPU\n";
+    std::cout << "  --symbols[=N]         Per-symbol counts and latency; list the top N by volume and p99\n";
+    std::cout << "                        (default N: 10)\n";
+    std::cout << "  --perf                Per-thread hardware counters (perf_event_open), per message\n";
+    std::cout << "  --flight[=N]          Flight recorder: keep the last N events per thread (default: 65536);\n";
+    std::cout << "                        SIGUSR1 dumps them\n";
+    std::cout << "  --flight-latency-us=N Dump when a latency exceeds N μs\n";
+    std::cout << "  --flight-gap          Dump on sequence gaps\n";
+    std::cout << "  --flight-dumps=N      Dumps written at most (default: 4)\n";
+    std::cout << "  --flight-prefix=PATH  Dump files are PATH-N.bin (default: ffp-flight); read with ffp-trace\n";
+    std::cout << "  --json=PATH           Write a machine-readable report (config, host, histogram, series)\n";
+    std::cout << "  --csv=PATH            Same report as CSV\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << program_name << "                    # Default: 500K msgs/s, 5s, 64K buffer\n";
     std::cout << "  " << program_name << " 1000000 10 17      # 1M msgs/s, 10s, 128K buffer\n";
-    std::cout << "  " << program_name << " 100000 30 15       # 100K msgs/s, 30s, 32K buffer\n\n";
+    std::cout << "  " << program_name << " 100000 30 15       # 100K msgs/s, 30s, 32K buffer\n";
+    std::cout << "  " << program_name << " 100000 10 16 --ab --line-loss-ppm=1000\n\n";
+}
+
+/**
+ * @brief Matches a "--name" or "--name=value" command line option
+ *
+ * @param arg Command line argument
+ * @param name Option name including the leading dashes
+ * @param value Receives the text after '=' (empty when absent)
+ * @return true if @p arg is the named option
+ */
+bool match_option(const std::string& arg, const char* name, std::string& value) {
+    std::string n(name);
+    if (arg == n) {
+        value.clear();
+        return true;
+    }
+    if (arg.size() > n.size() && arg.compare(0, n.size(), n) == 0 && arg[n.size()] == '=') {
+        value = arg.substr(n.size() + 1);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Parses a numeric option value and checks its range
+ *
+ * @throws std::invalid_argument if the value is missing, malformed or out of range
+ */
+uint64_t parse_option_value(const std::string& value, const char* name, uint64_t lo, uint64_t hi) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument(std::string(name) + " requires a numeric value");
+    }
+    uint64_t v = std::stoull(value);
+    if (v < lo || v > hi) {
+        throw std::invalid_argument(std::string(name) + " must be between " + std::to_string(lo) +
+                                    " and " + std::to_string(hi));
+    }
+    return v;
+}
+
+/**
+ * @brief Parses a floating-point option value and checks its range
+ *
+ * @throws std::invalid_argument if the value is missing, malformed or out of range
+ */
+double parse_option_double(const std::string& value, const char* name, double lo, double hi) {
+    size_t used = 0;
+    double v = 0.0;
+    try {
+        v = std::stod(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (value.empty() || used != value.size()) {
+        throw std::invalid_argument(std::string(name) + " requires a numeric value");
+    }
+    if (v < lo || v > hi) {
+        throw std::invalid_argument(std::string(name) + " must be between " + std::to_string(lo) +
+                                    " and " + std::to_string(hi));
+    }
+    return v;
+}
+
+/**
+ * @brief Prints one row of the per-interval time series
+ *
+ * @param row Interval counters and latency percentiles
+ * @param have_latency false if a consumer stopped before handing over its histogram
+ */
+void print_interval(const IntervalSample& row, bool have_latency) {
+    double secs = row.length_s > 0.0 ? row.length_s : 1.0;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[t=" << std::setw(7) << row.t_s << "s] prod " << std::setw(9)
+              << static_cast<uint64_t>(row.produced / secs) << "/s  cons " << std::setw(9)
+              << static_cast<uint64_t>(row.consumed / secs) << "/s  depth " << std::setw(8) << row.depth;
+    if (have_latency && row.consumed) {
+        std::cout << "  p50 " << std::setw(7) << row.p50 / 1000.0 << "  p99 " << std::setw(7)
+                  << row.p99 / 1000.0 << "  p99.9 " << std::setw(8) << row.p999 / 1000.0
+                  << "  max " << std::setw(8) << row.max / 1000.0 << " μs";
+    } else if (!have_latency) {
+        std::cout << "  (consumer stopped, latency n/a)";
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Prints A/B line arbitration results
+ *
+ * @param st Counters returned by the arbitration thread
+ */
+void print_arbiter_stats(const ArbiterStats& st) {
+    uint64_t fwd = st.forwarded();
+    auto share = [fwd](uint64_t n) { return fwd ? 100.0 * n / fwd : 0.0; };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "A/B Line Arbitration\n";
+    std::cout << "================================\n";
+    std::cout << "Forwarded:         " << std::setw(10) << fwd << "\n";
+    std::cout << "Line A wins:       " << std::setw(10) << st.wins[0] << " (" << share(st.wins[0]) << "%)\n";
+    std::cout << "Line B wins:       " << std::setw(10) << st.wins[1] << " (" << share(st.wins[1]) << "%)\n";
+    std::cout << "Duplicates:        " << std::setw(10) << st.duplicates << "\n";
+    std::cout << "Gap fills:         " << std::setw(10) << st.gap_fills << "\n";
+    std::cout << "Stale copies:      " << std::setw(10) << st.stale << "\n";
+    std::cout << "Lost (both lines): " << std::setw(10) << st.lost << "\n";
+    std::cout << "================================\n";
+}
+
+/**
+ * @brief Prints consumer reorder window results
+ *
+ * @param st Counters from the consumer's reorder window
+ */
+void print_reorder_stats(const ReorderStats& st) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Reorder Window\n";
+    std::cout << "================================\n";
+    std::cout << "In order:          " << std::setw(10) << st.in_order << "\n";
+    std::cout << "Held:              " << std::setw(10) << st.held << "\n";
+    std::cout << "Average hold:      " << std::setw(8) << (st.hold_ns_avg() / 1000.0) << " μs\n";
+    std::cout << "Maximum hold:      " << std::setw(8) << (st.hold_ns_max / 1000.0) << " μs\n";
+    std::cout << "Late (dropped):    " << std::setw(10) << st.late << "\n";
+    std::cout << "Skipped seqs:      " << std::setw(10) << st.skipped << "\n";
+    std::cout << "Gap timeouts:      " << std::setw(10) << st.timeouts << "\n";
+    std::cout << "================================\n";
+}
+
+/**
+ * @struct ConsumerShard
+ * @brief Queue, latency recorders and thread of one consumer shard
+ *
+ * Every shard records into its own instances, so consumers never contend;
+ * the reporter merges the interval histograms on read and the final report
+ * merges the run-long recorders exactly.
+ */
+struct ConsumerShard {
+    ConsumerShard(size_t capacity, int hdr_digits, double sketch_accuracy)
+        : queue(capacity),
+          histogram(3'600'000'000'000ULL, hdr_digits),
+          sketch(sketch_accuracy),
+          intervals(3'600'000'000'000ULL, hdr_digits) {}
+
+    SPSCQueue<RawMsg> queue;            ///< Messages for this shard
+    LatencyHistogram histogram;         ///< Run-long latency histogram
+    DDSketch sketch;                    ///< Run-long latency sketch
+    IntervalRecorder intervals;         ///< Per-interval histograms
+    std::unique_ptr<LatencySampler> sampler; ///< Optional raw samples
+    std::atomic<uint64_t> delivered{0}; ///< Messages delivered (monitoring)
+    std::unique_ptr<OutlierTracker> outliers; ///< Optional worst-K latencies
+    PerfCounters perf;                  ///< Consumer thread counters (--perf)
+    std::unique_ptr<SymbolStats> symbols; ///< Optional per-symbol breakdown
+    std::vector<std::unique_ptr<SPSCQueue<RawMsg>>> inputs; ///< Queues from producers 1..N-1
+    ConsumerContext ctx;                ///< Consumer configuration
+    std::thread thread;                 ///< Consumer thread
+};
+
+/**
+ * @struct ProducerSlot
+ * @brief Content sources, statistics and thread of one producer
+ *
+ * With --producers=N every producer owns a contiguous slice of the symbol
+ * universe and its own seeds; the results are merged after the join.
+ */
+struct ProducerSlot {
+    explicit ProducerSlot(int hdr_digits) : pacing(hdr_digits) {}
+
+    uint32_t first_symbol = 1;               ///< Lowest symbol id sent
+    uint32_t last_symbol = kSymbolCount;     ///< Highest symbol id sent
+    uint64_t target_rate = 0;                ///< This producer's share of the message rate
+    std::unique_ptr<SymbolSampler> sampler;  ///< Optional popularity over the slice
+    std::unique_ptr<QuoteModel> quotes;      ///< Optional random-walk quotes over the slice
+    std::unique_ptr<StallRing> stalls;       ///< Optional send stalls, by seq
+    std::optional<MessageCorpus> corpus;     ///< Optional pre-generated content
+    std::atomic<uint64_t> produced{0};       ///< Messages sent (monitoring, several producers)
+    PacingStats pacing;                      ///< Send schedule
+    GeneratorStats generator;                ///< Content generation cost
+    ProducerConfig cfg;                      ///< Producer configuration
+    std::thread thread;                      ///< Producer thread
+};
+
+/**
+ * @brief Prints each producer's symbol range and achieved rate
+ *
+ * @param producers Joined producers
+ */
+void print_producer_stats(const std::vector<std::unique_ptr<ProducerSlot>>& producers) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Producers\n";
+    std::cout << "================================\n";
+    std::cout << std::setw(8) << "producer" << std::setw(18) << "symbols" << std::setw(12) << "target"
+              << std::setw(12) << "achieved" << std::setw(10) << "catch-up" << std::setw(12) << "gen ns/msg"
+              << "\n";
+    for (size_t i = 0; i < producers.size(); ++i) {
+        const ProducerSlot& p = *producers[i];
+        std::cout << std::setw(8) << i << std::setw(18)
+                  << (std::to_string(p.first_symbol) + "-" + std::to_string(p.last_symbol)) << std::setw(12)
+                  << p.target_rate << std::setw(12) << static_cast<uint64_t>(p.pacing.achieved_rate())
+                  << std::setw(10) << p.pacing.catch_up << std::setw(12) << p.generator.ns_per_msg() << "\n";
+    }
+    // Producer 0 holds the most popular symbols and so the shortest period
+    std::cout << "Inter-arrival and lateness above are per producer (period "
+              << 1e6 / producers[0]->target_rate << " μs";
+    uint64_t slowest = producers[0]->target_rate;
+    for (const auto& p : producers) slowest = std::min(slowest, p->target_rate);
+    if (slowest != producers[0]->target_rate) std::cout << " to " << 1e6 / slowest << " μs";
+    std::cout << ")\n";
+    std::cout << "================================\n";
+}
+
+/**
+ * @brief Prints per-shard latency percentiles next to the merged totals
+ *
+ * @param shards Joined consumer shards
+ * @param use_hdr Read the HDR histograms (otherwise the sketches)
+ */
+void print_shard_stats(const std::vector<std::unique_ptr<ConsumerShard>>& shards, bool use_hdr) {
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Consumer Shards\n";
+    std::cout << "================================\n";
+    std::cout << std::setw(6) << "shard" << std::setw(12) << "messages" << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << " μs\n";
+    for (size_t i = 0; i < shards.size(); ++i) {
+        auto row = [&](const auto& rec) {
+            std::cout << std::setw(6) << i << std::setw(12) << rec.count() << std::setw(10)
+                      << us(rec.value_at_quantile(0.50)) << std::setw(10) << us(rec.value_at_quantile(0.99))
+                      << std::setw(10) << us(rec.value_at_quantile(0.999)) << std::setw(10) << us(rec.max())
+                      << "\n";
+        };
+        if (use_hdr) {
+            row(shards[i]->histogram);
+        } else {
+            row(shards[i]->sketch);
+        }
+    }
+    std::cout << "================================\n";
+}
+
+/**
+ * @brief Prints the per-stage latency breakdown of traced messages
+ *
+ * @param tr Tracer filled by the producer and consumer threads
+ */
+void print_trace_stats(const StageTracer& tr) {
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Stage Latency (1 in " << tr.sample_every() << " traced)\n";
+    std::cout << "================================\n";
+    std::cout << std::setw(12) << "stage" << std::setw(10) << "p50" << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9" << std::setw(10) << "max" << " μs\n";
+    auto row = [&](const char* name, const LatencyHistogram& h) {
+        std::cout << std::setw(12) << name << std::setw(10) << us(h.value_at_quantile(0.50))
+                  << std::setw(10) << us(h.value_at_quantile(0.99)) << std::setw(10)
+                  << us(h.value_at_quantile(0.999)) << std::setw(10) << us(h.max()) << "\n";
+    };
+    for (size_t i = 0; i < StageTracer::kIntervals; ++i) {
+        row(StageTracer::interval_name(i), tr.stage_histogram(i));
+    }
+    row("total", tr.total_histogram());
+    std::cout << "Traced samples:    " << std::setw(10) << tr.total_histogram().count() << "\n";
+    std::cout << "Slot overruns:     " << std::setw(10) << tr.overruns() << "\n";
+    std::cout << "================================\n";
+}
+
+/**
+ * @brief Prints the worst latencies with the context they were delivered in
+ *
+ * @param outliers Outliers, worst first
+ * @param t_start_ns Run start on the steady clock
+ */
+void print_outliers(const std::vector<Outlier>& outliers, uint64_t t_start_ns) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Worst " << outliers.size() << " Latencies\n";
+    std::cout << "================================\n";
+    std::cout << std::setw(5) << "rank" << std::setw(12) << "latency μs" << std::setw(12) << "seq"
+              << std::setw(8) << "symbol" << std::setw(8) << "depth" << std::setw(12) << "stall μs"
+              << std::setw(5) << "cpu" << std::setw(10) << "t (s)" << "\n";
+    for (size_t i = 0; i < outliers.size(); ++i) {
+        const Outlier& o = outliers[i];
+        double t = o.t_recv_ns > t_start_ns ? (o.t_recv_ns - t_start_ns) / 1e9 : 0.0;
+        std::cout << std::setw(5) << (i + 1) << std::setw(11) << o.latency_ns / 1000.0 << std::setw(12)
+                  << o.seq << std::setw(8) << o.symbol_id << std::setw(8) << o.queue_depth << std::setw(11)
+                  << o.producer_stall_ns / 1000.0 << std::setw(5) << o.cpu << std::setw(10) << t << "\n";
+    }
+    std::cout << "================================\n";
+}
+
+/**
+ * @brief Prints the busiest symbols and the symbols with the worst p99
+ *
+ * @param by_volume Top symbols by message count
+ * @param by_p99 Top symbols by p99 latency
+ * @param active Symbols that received at least one message
+ * @param run_seconds Measured run time
+ */
+void print_symbol_stats(const std::vector<SymbolSummary>& by_volume, const std::vector<SymbolSummary>& by_p99,
+                        size_t active, double run_seconds) {
+    auto table = [&](const char* title, const std::vector<SymbolSummary>& rows) {
+        std::cout << "\n================================\n";
+        std::cout << title << "\n";
+        std::cout << "================================\n";
+        std::cout << std::setw(8) << "symbol" << std::setw(10) << "messages" << std::setw(10) << "msgs/s"
+                  << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max" << " μs\n";
+        for (const SymbolSummary& s : rows) {
+            std::cout << std::setw(8) << s.symbol_id << std::setw(10) << s.count << std::setw(10)
+                      << std::setprecision(0) << (run_seconds > 0.0 ? s.count / run_seconds : 0.0)
+                      << std::setprecision(2) << std::setw(10) << s.p50 / 1000.0 << std::setw(10) << s.p99 / 1000.0
+                      << std::setw(10) << s.max / 1000.0 << "\n";
+        }
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    table("Top Symbols by Volume", by_volume);
+    table("Top Symbols by p99 (>= 100 msgs)", by_p99);
+    std::cout << "Active symbols:    " << std::setw(10) << active << "\n";
+    std::cout << "Percentiles are bucket upper bounds (within 25%)\n";
+    std::cout << "================================\n";
+}
+
+/**
+ * @struct PerfSnapshot
+ * @brief Producer and consumer counters with the message counts they cover
+ */
+struct PerfSnapshot {
+    PerfReading producer;
+    PerfReading consumer;   ///< Summed over all shards
+    uint64_t produced = 0;
+    uint64_t consumed = 0;
+
+    PerfSnapshot operator-(const PerfSnapshot& earlier) const {
+        return {producer - earlier.producer, consumer - earlier.consumer, produced - earlier.produced,
+                consumed - earlier.consumed};
+    }
+};
+
+/**
+ * @brief Reads every pipeline thread's counters
+ */
+PerfSnapshot take_perf_snapshot(const PerfCounters& producer,
+                                const std::vector<std::unique_ptr<ConsumerShard>>& shards,
+                                uint64_t produced, uint64_t consumed) {
+    PerfSnapshot s;
+    s.producer = producer.read();
+    s.consumer = shards[0]->perf.read();
+    for (size_t i = 1; i < shards.size(); ++i) s.consumer += shards[i]->perf.read();
+    s.produced = produced;
+    s.consumed = consumed;
+    return s;
+}
+
+/**
+ * @brief Counter values per message, e.g. {"producer_cycles_per_msg", 412.5}
+ *
+ * Unavailable counters are left out; IPC is added when cycles and
+ * instructions are both available.
+ */
+std::vector<std::pair<std::string, double>> perf_per_message(const PerfSnapshot& d) {
+    std::vector<std::pair<std::string, double>> out;
+    auto side = [&](const char* name, const PerfReading& r, uint64_t msgs) {
+        if (!msgs) return;
+        for (size_t i = 0; i < kPerfEvents; ++i) {
+            if (!r.valid[i]) continue;
+            std::string key = std::string(name) + "_" + PerfCounters::event_name(i) + "_per_msg";
+            std::replace(key.begin(), key.end(), '-', '_');
+            out.emplace_back(key, static_cast<double>(r.value[i]) / msgs);
+        }
+        const size_t cyc = static_cast<size_t>(PerfEvent::Cycles);
+        const size_t ins = static_cast<size_t>(PerfEvent::Instructions);
+        if (r.valid[cyc] && r.valid[ins] && r.value[cyc]) {
+            out.emplace_back(std::string(name) + "_ipc", static_cast<double>(r.value[ins]) / r.value[cyc]);
+        }
+    };
+    side("producer", d.producer, d.produced);
+    side("consumer", d.consumer, d.consumed);
+    return out;
+}
+
+/**
+ * @brief Prints producer and consumer counters normalized per message
+ *
+ * @param d Counters over the measured window
+ * @param after_warmup Window excludes the first interval
+ * @param error Why a counter could not be opened (empty if all opened)
+ */
+void print_perf_stats(const PerfSnapshot& d, bool after_warmup, const std::string& error) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Hardware Counters per Message" << (after_warmup ? " (after first interval)" : "") << "\n";
+    std::cout << "================================\n";
+    std::cout << std::setw(14) << "event" << std::setw(12) << "producer" << std::setw(12) << "consumer" << "\n";
+    auto cell = [](const PerfReading& r, size_t i, uint64_t msgs) {
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(2);
+        if (r.valid[i] && msgs) {
+            s << static_cast<double>(r.value[i]) / msgs;
+        } else {
+            s << "n/a";
+        }
+        return s.str();
+    };
+    for (size_t i = 0; i < kPerfEvents; ++i) {
+        std::cout << std::setw(14) << PerfCounters::event_name(i) << std::setw(12)
+                  << cell(d.producer, i, d.produced) << std::setw(12) << cell(d.consumer, i, d.consumed) << "\n";
+    }
+    std::cout << "Messages:     " << std::setw(13) << d.produced << std::setw(12) << d.consumed << "\n";
+    if (!error.empty()) {
+        std::cout << "[WARN] Some counters are unavailable (" << error << "); VMs and containers often\n"
+                  << "       lack a virtual PMU, or kernel.perf_event_paranoid forbids them\n";
+    }
+    std::cout << "================================\n";
+}
+
+const char* pacing_name(PacingMode mode) {
+    return mode == PacingMode::Sleep ? "sleep" : mode == PacingMode::Spin ? "spin" : "absolute";
+}
+
+/**
+ * @brief Achieved rate, catch-up count and send-time distributions as report fields
+ */
+std::vector<std::pair<std::string, double>> pacing_summary(const PacingStats& ps, uint64_t target_rate,
+                                                           const GeneratorStats& gen) {
+    std::vector<std::pair<std::string, double>> out = {
+        {"target_rate", static_cast<double>(target_rate)},
+        {"scheduled_rate", ps.scheduled_rate()},
+        {"achieved_rate", ps.achieved_rate()},
+        {"catch_up", static_cast<double>(ps.catch_up)},
+        {"generator_ns_per_msg", gen.ns_per_msg()},
+    };
+    const std::pair<const char*, double> quantiles[] = {{"p50", 0.50}, {"p90", 0.90}, {"p99", 0.99}, {"p999", 0.999}};
+    for (const auto& [name, q] : quantiles) {
+        out.emplace_back(std::string("interval_") + name + "_ns",
+                         static_cast<double>(ps.intervals.value_at_quantile(q)));
+    }
+    out.emplace_back("interval_max_ns", static_cast<double>(ps.intervals.max()));
+    if (ps.lateness.count()) {
+        for (const auto& [name, q] : quantiles) {
+            out.emplace_back(std::string("lateness_") + name + "_ns",
+                             static_cast<double>(ps.lateness.value_at_quantile(q)));
+        }
+        out.emplace_back("lateness_max_ns", static_cast<double>(ps.lateness.max()));
+    }
+    return out;
+}
+
+/**
+ * @brief Prints achieved versus target rate and the inter-arrival distribution
+ *
+ * @param traffic Profile and arrival process; with anything but a constant
+ *        schedule the achieved rate is compared with the scheduled average
+ */
+void print_pacing_stats(const PacingStats& ps, uint64_t target_rate, PacingMode mode, const std::string& traffic,
+                        const GeneratorStats& gen, const std::string& generator) {
+    const double period_us = 1e6 / target_rate;
+    const double achieved = ps.achieved_rate();
+    const bool varying = traffic != "constant";
+    const double target = varying && ps.scheduled_rate() > 0.0 ? ps.scheduled_rate() : target_rate;
+    // Each cell is a space and 10 digits wide: room for seconds-long stalls
+    auto row = [](const char* label, const LatencyHistogram& h) {
+        std::cout << label;
+        for (double q : {0.50, 0.90, 0.99, 0.999}) std::cout << " " << std::setw(10) << h.value_at_quantile(q) / 1000.0;
+        std::cout << " " << std::setw(10) << h.max() / 1000.0 << "\n";
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n================================\n";
+    std::cout << "Send Pacing (" << pacing_name(mode) << ", " << traffic << ")\n";
+    std::cout << "================================\n";
+    std::cout << (varying ? "Base rate:         " : "Target rate:       ") << std::setw(12) << target_rate
+              << " msgs/s\n";
+    if (varying) {
+        std::cout << "Scheduled rate:    " << std::setw(12) << static_cast<uint64_t>(target) << " msgs/s (average)\n";
+    }
+    std::cout << "Achieved rate:     " << std::setw(12) << static_cast<uint64_t>(achieved) << " msgs/s ("
+              << achieved * 100.0 / target << "%)\n";
+    std::cout << "Generator:         " << std::setw(12) << gen.ns_per_msg() << " ns/msg (" << generator << ")\n";
+    if (ps.lateness.count()) {
+        std::cout << "Catch-up sends:    " << std::setw(12) << ps.catch_up << " ("
+                  << (ps.sent ? ps.catch_up * 100.0 / ps.sent : 0.0) << "% a period or more late)\n";
+    }
+    std::cout << "μs              ";
+    for (const char* col : {"p50", "p90", "p99", "p99.9", "max"}) std::cout << " " << std::setw(10) << col;
+    std::cout << "\n";
+    row("Inter-arrival:  ", ps.intervals);
+    if (ps.lateness.count()) row("Lateness:       ", ps.lateness);
+    std::cout << (varying ? "Base period:     " : "Target period:   ") << " " << std::setw(10) << period_us << "\n";
+    std::cout << "================================\n";
 }
 
 /**
@@ -100,9 +690,63 @@ int main(int argc, char** argv) {
         uint64_t msgs_per_sec = 500000;  // Default: 500K msgs/s
         int total_seconds = 5;            // Default: 5 seconds
         size_t buf_pow2 = 1 << 16;       // Default: 65536 elements
+        bool ab_lines = false;            // Default: single feed line
+        uint32_t line_loss_ppm = 0;       // Default: lossless lines
+        size_t arb_window = 1 << 12;     // Default: 4096-sequence arbitration window
+        size_t reorder_slots = 0;         // Default: no reorder window
+        uint64_t reorder_timeout_us = 100;  // Default: 100us maximum hold
+        int hdr_digits = 3;               // Default: 3 significant digits
+        size_t raw_samples = 0;           // Default: histogram only
+        LatencySampler::Mode sampling = LatencySampler::Mode::First;
+        bool use_hdr = true;              // Default: HDR histogram recorder
+        bool use_sketch = false;
+        double sketch_accuracy = 0.01;    // Default: 1% relative accuracy
+        uint64_t interval_ms = 1000;      // Default: report once per second
+        bool co_intended = false;         // Default: stamp actual send time
+        PacingMode pacing = PacingMode::Spin;  // Default: absolute deadlines, busy-wait the last spin_us
+        bool pacing_given = false;        // --pacing overrides the single-CPU fallback
+        uint64_t spin_us = 50;
+        TrafficProfile traffic;           // Default: constant rate
+        bool poisson = false;             // Default: evenly spaced arrivals
+        uint32_t universe = kSymbolCount; // Default: symbols 1..1000
+        double zipf = 0.0;                // Default: uniform popularity
+        bool price_walk = false;          // Default: independent uniform prices
+        bool batch_rng = true;            // Default: batched xoshiro256** content
+        uint64_t seed = 12345;
+        size_t corpus_msgs = 0;           // Default: generate content live
+        std::string corpus_file;
+        std::string corpus_save;
+        bool co_backfill = false;         // Default: no back-filled samples
+        uint64_t trace_every = 0;         // Default: no stage tracing
+        std::string shm_name;             // Default: no shared-memory export
+        int prometheus_port = -1;         // Default: no HTTP endpoint
+        size_t flight_events = 0;         // Default: no flight recorder
+        uint64_t flight_latency_us = 0;
+        bool flight_gap = false;
+        size_t flight_dumps = 4;
+        std::string flight_prefix = "ffp-flight";
+        size_t shard_count = 1;           // Default: single consumer
+        size_t producer_count = 1;        // Default: single producer
+        size_t outlier_count = 0;         // Default: no outlier capture
+        bool use_perf = false;            // Default: no hardware counters
+        size_t symbol_top = 0;            // Default: no per-symbol breakdown
+        std::string json_path;            // Default: console output only
+        std::string csv_path;
+
+        // Positional arguments come first; --options may appear anywhere
+        std::vector<std::string> args;
+        std::vector<std::string> options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) == 0) {
+                options.push_back(arg);
+            } else {
+                args.push_back(arg);
+            }
+        }
 
-        if (argc >= 2) {
-            msgs_per_sec = std::stoull(argv[1]);
+        if (args.size() >= 1) {
+            msgs_per_sec = std::stoull(args[0]);
             if (msgs_per_sec == 0 || msgs_per_sec > 10000000) {
                 std::cerr << "[ERROR] Invalid message rate. Must be between 1 and 10,000,000\n";
                 print_usage(argv[0]);
@@ -110,8 +754,8 @@ int main(int argc, char** argv) {
             }
         }
 
-        if (argc >= 3) {
-            total_seconds = std::stoi(argv[2]);
+        if (args.size() >= 2) {
+            total_seconds = std::stoi(args[1]);
             if (total_seconds <= 0 || total_seconds > 3600) {
                 std::cerr << "[ERROR] Invalid duration. Must be between 1 and 3600 seconds\n";
                 print_usage(argv[0]);
@@ -119,8 +763,8 @@ int main(int argc, char** argv) {
             }
         }
 
-        if (argc >= 4) {
-            uint32_t pow2 = std::stoul(argv[3]);
+        if (args.size() >= 3) {
+            uint32_t pow2 = std::stoul(args[2]);
             if (pow2 < 10 || pow2 > 24) {
                 std::cerr << "[ERROR] Invalid buffer size. Power must be between 10 and 24\n";
                 print_usage(argv[0]);
@@ -129,66 +773,823 @@ int main(int argc, char** argv) {
             buf_pow2 = static_cast<size_t>(1ULL << pow2);
         }
 
+        try {
+            for (const std::string& opt : options) {
+                std::string value;
+                if (match_option(opt, "--ab", value)) {
+                    ab_lines = true;
+                } else if (match_option(opt, "--line-loss-ppm", value)) {
+                    line_loss_ppm = static_cast<uint32_t>(
+                        parse_option_value(value, "--line-loss-ppm", 0, 1000000));
+                } else if (match_option(opt, "--arb-window", value)) {
+                    arb_window = static_cast<size_t>(1ULL << parse_option_value(value, "--arb-window", 6, 24));
+                } else if (match_option(opt, "--reorder", value)) {
+                    reorder_slots = static_cast<size_t>(1ULL << parse_option_value(value, "--reorder", 1, 20));
+                } else if (match_option(opt, "--reorder-timeout-us", value)) {
+                    reorder_timeout_us = parse_option_value(value, "--reorder-timeout-us", 1, 10000000);
+                } else if (match_option(opt, "--hdr-digits", value)) {
+                    hdr_digits = static_cast<int>(parse_option_value(value, "--hdr-digits", 1, 5));
+                } else if (match_option(opt, "--raw-samples", value)) {
+                    raw_samples = static_cast<size_t>(parse_option_value(value, "--raw-samples", 0, 1ULL << 32));
+                } else if (match_option(opt, "--sampling", value)) {
+                    if (value == "first") {
+                        sampling = LatencySampler::Mode::First;
+                    } else if (value == "reservoir") {
+                        sampling = LatencySampler::Mode::Reservoir;
+                    } else if (value == "stratified") {
+                        sampling = LatencySampler::Mode::Stratified;
+                    } else {
+                        throw std::invalid_argument("--sampling must be first, reservoir or stratified");
+                    }
+                } else if (match_option(opt, "--recorder", value)) {
+                    if (value != "hdr" && value != "ddsketch" && value != "both") {
+                        throw std::invalid_argument("--recorder must be hdr, ddsketch or both");
+                    }
+                    use_hdr = value != "ddsketch";
+                    use_sketch = value != "hdr";
+                } else if (match_option(opt, "--sketch-accuracy", value)) {
+                    sketch_accuracy = parse_option_double(value, "--sketch-accuracy", 0.01, 50.0) / 100.0;
+                } else if (match_option(opt, "--interval-ms", value)) {
+                    interval_ms = parse_option_value(value, "--interval-ms", 10, 60000);
+                } else if (match_option(opt, "--co", value)) {
+                    if (value == "both") {
+                        throw std::invalid_argument("--co=both would correct every stall twice; use intended or backfill");
+                    }
+                    if (value != "off" && value != "intended" && value != "backfill") {
+                        throw std::invalid_argument("--co must be off, intended or backfill");
+                    }
+                    co_intended = value == "intended";
+                    co_backfill = value == "backfill";
+                } else if (match_option(opt, "--pacing", value)) {
+                    pacing_given = true;
+                    if (value == "sleep") {
+                        pacing = PacingMode::Sleep;
+                    } else if (value == "absolute") {
+                        pacing = PacingMode::Absolute;
+                    } else if (value == "spin") {
+                        pacing = PacingMode::Spin;
+                    } else {
+                        throw std::invalid_argument("--pacing must be sleep, absolute or spin");
+                    }
+                } else if (match_option(opt, "--traffic", value)) {
+                    traffic = TrafficProfile::parse(value);
+                } else if (match_option(opt, "--arrivals", value)) {
+                    if (value != "uniform" && value != "poisson") {
+                        throw std::invalid_argument("--arrivals must be uniform or poisson");
+                    }
+                    poisson = value == "poisson";
+                } else if (match_option(opt, "--prices", value)) {
+                    if (value != "uniform" && value != "walk") {
+                        throw std::invalid_argument("--prices must be uniform or walk");
+                    }
+                    price_walk = value == "walk";
+                } else if (match_option(opt, "--rng", value)) {
+                    if (value != "batch" && value != "mt19937") {
+                        throw std::invalid_argument("--rng must be batch or mt19937");
+                    }
+                    batch_rng = value == "batch";
+                } else if (match_option(opt, "--seed", value)) {
+                    seed = parse_option_value(value, "--seed", 0, UINT64_MAX);
+                } else if (match_option(opt, "--corpus", value)) {
+                    corpus_msgs = parse_option_value(value, "--corpus", 1, MessageCorpus::kMaxMessages / 1'000'000) *
+                                  1'000'000;
+                } else if (match_option(opt, "--corpus-file", value)) {
+                    if (value.empty()) throw std::invalid_argument("--corpus-file requires a path");
+                    corpus_file = value;
+                } else if (match_option(opt, "--corpus-save", value)) {
+                    if (value.empty()) throw std::invalid_argument("--corpus-save requires a path");
+                    corpus_save = value;
+                } else if (match_option(opt, "--spin-us", value)) {
+                    spin_us = parse_option_value(value, "--spin-us", 0, 1'000'000);
+                } else if (match_option(opt, "--shm", value)) {
+                    shm_name = value.empty() ? kMetricsDefaultName : value;
+                    if (shm_name[0] != '/' || shm_name.find('/', 1) != std::string::npos) {
+                        throw std::invalid_argument("--shm name must look like /name");
+                    }
+                } else if (match_option(opt, "--prometheus", value)) {
+                    prometheus_port = value.empty() ? 9464 : static_cast<int>(
+                        parse_option_value(value, "--prometheus", 0, 65535));
+                } else if (match_option(opt, "--flight", value)) {
+                    flight_events = value.empty() ? 65536 : static_cast<size_t>(
+                        parse_option_value(value, "--flight", 64, 1ULL << 24));
+                    if (!std::has_single_bit(flight_events)) {
+                        throw std::invalid_argument("--flight must be a power of 2");
+                    }
+                } else if (match_option(opt, "--flight-latency-us", value)) {
+                    flight_latency_us = parse_option_value(value, "--flight-latency-us", 1, 60'000'000);
+                } else if (opt == "--flight-gap") {
+                    flight_gap = true;
+                } else if (match_option(opt, "--flight-dumps", value)) {
+                    flight_dumps = static_cast<size_t>(parse_option_value(value, "--flight-dumps", 1, 1000));
+                } else if (match_option(opt, "--flight-prefix", value)) {
+                    if (value.empty()) throw std::invalid_argument("--flight-prefix requires a path");
+                    flight_prefix = value;
+                } else if (match_option(opt, "--universe", value)) {
+                    universe = static_cast<uint32_t>(
+                        parse_option_value(value, "--universe", 1, SymbolSampler::kMaxUniverse));
+                } else if (match_option(opt, "--zipf", value)) {
+                    zipf = parse_option_double(value, "--zipf", 0.0, 4.0);
+                } else if (match_option(opt, "--shards", value)) {
+                    shard_count = static_cast<size_t>(parse_option_value(value, "--shards", 1, 64));
+                } else if (match_option(opt, "--producers", value)) {
+                    producer_count = static_cast<size_t>(parse_option_value(value, "--producers", 1, 16));
+                } else if (match_option(opt, "--outliers", value)) {
+                    outlier_count = static_cast<size_t>(parse_option_value(value, "--outliers", 1, 100000));
+                } else if (match_option(opt, "--symbols", value)) {
+                    symbol_top = value.empty() ? 10 : static_cast<size_t>(
+                        parse_option_value(value, "--symbols", 1, kSymbolCount));
+                } else if (opt == "--perf") {
+                    use_perf = true;
+                } else if (match_option(opt, "--json", value)) {
+                    if (value.empty()) throw std::invalid_argument("--json requires a file name");
+                    json_path = value;
+                } else if (match_option(opt, "--csv", value)) {
+                    if (value.empty()) throw std::invalid_argument("--csv requires a file name");
+                    csv_path = value;
+                } else if (match_option(opt, "--trace-every", value)) {
+                    trace_every = parse_option_value(value, "--trace-every", 1, 1ULL << 20);
+                    if (!std::has_single_bit(trace_every)) {
+                        throw std::invalid_argument("--trace-every must be a power of 2");
+                    }
+                } else {
+                    throw std::invalid_argument("Unknown option " + opt);
+                }
+            }
+            if (shard_count > 1 && (ab_lines || reorder_slots || !shm_name.empty() || prometheus_port >= 0)) {
+                throw std::invalid_argument("--shards cannot be combined with --ab, --reorder, --shm or --prometheus");
+            }
+            // The tracer's slots are finished by one consumer; other shards' messages would go untraced
+            if (shard_count > 1 && trace_every) {
+                throw std::invalid_argument("--trace-every needs a single consumer (cannot be combined with --shards)");
+            }
+            if ((flight_latency_us || flight_gap) && !flight_events) flight_events = 65536;
+            if (flight_gap && shard_count > 1) {
+                throw std::invalid_argument("--flight-gap needs a single consumer (shards see partial sequences)");
+            }
+            if (!corpus_save.empty() && !corpus_msgs) {
+                throw std::invalid_argument("--corpus-save needs --corpus=N");
+            }
+            if (corpus_msgs && !corpus_file.empty()) {
+                throw std::invalid_argument("--corpus and --corpus-file are mutually exclusive");
+            }
+            // Several producers interleave their sequence numbers, so nothing
+            // downstream may expect one contiguous stream
+            if (producer_count > 1 && (ab_lines || reorder_slots || flight_gap || trace_every ||
+                                       !shm_name.empty() || prometheus_port >= 0 || !corpus_file.empty() ||
+                                       !corpus_save.empty())) {
+                throw std::invalid_argument("--producers cannot be combined with --ab, --reorder, --flight-gap, "
+                                            "--trace-every, --shm, --prometheus, --corpus-file or --corpus-save");
+            }
+            if (producer_count > universe || producer_count > msgs_per_sec) {
+                throw std::invalid_argument("--producers needs at least one symbol and one msg/s per producer");
+            }
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "[ERROR] " << e.what() << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+        // Busy-waiting needs a core of its own: on a single CPU it takes the consumer's time slices
+        if (!pacing_given && std::thread::hardware_concurrency() == 1) {
+            pacing = PacingMode::Absolute;
+            std::cout << "[INFO] Single CPU: pacing by sleeping until each deadline (--pacing=spin to override)\n";
+        }
+
         // Display configuration
         std::cout << "[CONFIG] Test Parameters:\n";
         std::cout << "  Message rate:  " << std::setw(10) << msgs_per_sec << " msgs/sec\n";
         std::cout << "  Duration:      " << std::setw(10) << total_seconds << " seconds\n";
         std::cout << "  Buffer size:   " << std::setw(10) << buf_pow2 << " elements\n";
-        std::cout << "  Expected msgs: " << std::setw(10) << (msgs_per_sec * total_seconds) << " total\n\n";
+        std::cout << "  Expected msgs: " << std::setw(10) << (msgs_per_sec * total_seconds) << " total\n";
+        if (ab_lines) {
+            std::cout << "  Feed lines:    " << std::setw(10) << "A/B" << " (loss " << line_loss_ppm
+                      << " ppm/line, window " << arb_window << ")\n";
+        }
+        if (reorder_slots) {
+            std::cout << "  Reorder:       " << std::setw(10) << reorder_slots << " slots ("
+                      << reorder_timeout_us << " us timeout)\n";
+        }
+        if (shard_count > 1) {
+            std::cout << "  Consumers:     " << std::setw(10) << shard_count << " shards (by symbol)\n";
+        }
+        if (producer_count > 1) {
+            std::cout << "  Producers:     " << std::setw(10) << producer_count << " (disjoint symbol ranges)\n";
+        }
+        std::cout << "  Pacing:        " << std::setw(10) << pacing_name(pacing);
+        if (pacing == PacingMode::Spin) std::cout << " (spin " << spin_us << " us)";
+        std::cout << "\n";
+        if (universe != kSymbolCount || zipf > 0.0) {
+            std::cout << "  Symbols:       " << std::setw(10) << universe << " (zipf " << zipf << ")\n";
+        }
+        if (price_walk) {
+            std::cout << "  Prices:        " << std::setw(10) << "walk" << " (bid/ask on tick grids, Pareto lots)\n";
+        }
+        if (traffic.shape() != TrafficProfile::Shape::Constant || poisson) {
+            std::cout << "  Traffic:       " << std::setw(10) << traffic.spec() << " (peak " << traffic.peak()
+                      << "x, " << (poisson ? "poisson" : "uniform") << " arrivals)\n";
+        }
+        if (co_intended || co_backfill) {
+            std::cout << "  CO correction: " << std::setw(10) << (co_intended ? "intended" : "backfill")
+                      << " (schedule " << (1'000'000'000ULL / msgs_per_sec) << " ns/msg)\n";
+        }
+        std::cout << "\n";
 
         // Register signal handler for graceful shutdown
         signal(SIGINT, sigint_handler);
 
-        // Initialize SPSC queue
-        std::cout << "[INFO] Initializing lock-free SPSC queue...\n";
-        SPSCQueue<RawMsg> q(buf_pow2);
+        // Initialize one SPSC queue per consumer shard; shard 0's queue is
+        // the main queue
+        std::cout << "[INFO] Initializing lock-free SPSC queue" << (shard_count > 1 ? "s" : "") << "...\n";
+        std::vector<std::unique_ptr<ConsumerShard>> shards;
+        for (size_t i = 0; i < shard_count; ++i) {
+            shards.push_back(std::make_unique<ConsumerShard>(buf_pow2, hdr_digits, sketch_accuracy));
+        }
+        SPSCQueue<RawMsg>& q = shards[0]->queue;
+
+        // With --ab, the producer feeds two line queues and the arbiter feeds q
+        std::unique_ptr<SPSCQueue<RawMsg>> line_a;
+        std::unique_ptr<SPSCQueue<RawMsg>> line_b;
+        ArbiterStats arb_stats;
+        if (ab_lines) {
+            line_a = std::make_unique<SPSCQueue<RawMsg>>(buf_pow2);
+            line_b = std::make_unique<SPSCQueue<RawMsg>>(buf_pow2);
+        }
+
+        // Fixed-memory latency recorders covering the whole run: one per
+        // shard, merged exactly for the report
+        LatencyHistogram histogram(3'600'000'000'000ULL, hdr_digits);
+        DDSketch sketch(sketch_accuracy);
+        if (use_hdr) {
+            std::cout << "[INFO] Latency histogram: " << hdr_digits << " significant digits, "
+                      << (histogram.counts_size() * sizeof(uint64_t) / 1024) << " KB per shard\n";
+        }
+        if (use_sketch) {
+            std::cout << "[INFO] Latency sketch: " << (sketch_accuracy * 100.0) << "% relative accuracy, "
+                      << (sketch.memory_bytes() / 1024) << " KB per shard\n";
+        }
+
+        // Per-interval histograms handed from the consumers to the monitor loop
+        LatencyHistogram interval_merged(3'600'000'000'000ULL, hdr_digits);
+        std::vector<IntervalSample> series;
+        series.reserve(static_cast<size_t>(total_seconds * 1000 / interval_ms) + 2);
+
+        // Optional live export for external monitors (ffp-stat, Prometheus);
+        // the hot threads then count directly into the metrics region, which
+        // lives in shared memory with --shm and in this process otherwise
+        std::unique_ptr<SharedMetrics> shm;
+        std::unique_ptr<MetricsRegion> local_metrics;
+        MetricsRegion* metrics = nullptr;
+        if (!shm_name.empty()) {
+            shm = std::make_unique<SharedMetrics>(shm_name, SharedMetrics::Mode::Create);
+            metrics = &shm->region();
+            std::cout << "[INFO] Publishing live metrics in shared memory " << shm_name
+                      << " (attach with ffp-stat)\n";
+        } else if (prometheus_port >= 0) {
+            local_metrics = std::make_unique<MetricsRegion>();
+            metrics = local_metrics.get();
+        }
+        if (metrics) {
+            metrics->target_rate.store(msgs_per_sec, std::memory_order_relaxed);
+            metrics->queue_capacity.store(buf_pow2, std::memory_order_relaxed);
+            metrics->running.store(1, std::memory_order_release);
+        }
+        std::unique_ptr<PrometheusExporter> exporter;
+        if (prometheus_port >= 0) {
+            exporter = std::make_unique<PrometheusExporter>(*metrics, static_cast<uint16_t>(prometheus_port));
+            std::cout << "[INFO] Serving Prometheus metrics on http://127.0.0.1:" << exporter->port()
+                      << "/metrics\n";
+        }
+        std::atomic<uint64_t> local_produced{0};
+        std::atomic<uint64_t>& produced = metrics ? metrics->produced : local_produced;
+
+        // Optional sampled per-stage timestamps
+        std::unique_ptr<StageTracer> tracer;
+        if (trace_every) {
+            tracer = std::make_unique<StageTracer>(trace_every, 4096, hdr_digits);
+        }
+
+        // Optional worst-K outliers: one tracker per shard
+        if (outlier_count) {
+            for (auto& s : shards) s->outliers = std::make_unique<OutlierTracker>(outlier_count);
+        }
+        // Producer stalls, looked up by seq for outlier context and back-fill:
+        // a ring per producer, with a slot for every message it can have in
+        // flight (its shard queues, plus both lines and the merged queue with --ab)
+        const bool track_stalls = outlier_count || co_backfill;
+        const size_t stall_slots =
+            std::clamp<size_t>(std::bit_ceil(buf_pow2 * (shard_count + (ab_lines ? 2 : 0))), 65536, size_t{1} << 24);
+
+        // Producers: each owns a contiguous slice of the symbol universe and
+        // its own seeds; a single producer covers the whole universe as before.
+        // Producer p holds the popularity ranks p + 1, p + 1 + N, ... (slice
+        // sizes match), and its rate follows their share of the Zipf mass, so
+        // the merged feed is Zipf over the whole universe
+        std::vector<std::unique_ptr<ProducerSlot>> producers;
+        std::vector<double> mass(producer_count);
+        for (size_t p = 0; p < producer_count; ++p) {
+            auto slot = std::make_unique<ProducerSlot>(hdr_digits);
+            const size_t base = universe / producer_count, extra = universe % producer_count;
+            const auto span = static_cast<uint32_t>(base + (p < extra ? 1 : 0));
+            slot->first_symbol = static_cast<uint32_t>(base * p + std::min(p, extra)) + 1;
+            slot->last_symbol = slot->first_symbol + span - 1;
+            ProducerConfig& c = slot->cfg;
+            c.index = static_cast<unsigned>(p);
+            c.producers = static_cast<unsigned>(producer_count);
+            c.symbol_base = slot->first_symbol - 1;
+            c.symbol_range = span;
+            c.batch_rng = batch_rng;
+            c.seed = seed + p;
+            // Optional skewed symbol popularity; the default draws uniformly
+            // from 1..kSymbolCount as before
+            if (universe != kSymbolCount || zipf > 0.0) {
+                slot->sampler = std::make_unique<SymbolSampler>(span, zipf, 0x9E3779B97F4A7C15ULL + p,
+                                                                static_cast<uint32_t>(p + 1),
+                                                                static_cast<uint32_t>(producer_count));
+                c.symbols = slot->sampler.get();
+            }
+            mass[p] = slot->sampler ? slot->sampler->mass() : span;
+            // Optional random-walk quotes, one book per symbol id
+            if (price_walk) {
+                slot->quotes = std::make_unique<QuoteModel>(slot->last_symbol, 0xA0761D6478BD642FULL + p,
+                                                            slot->first_symbol);
+                c.quotes = slot->quotes.get();
+            }
+            producers.push_back(std::move(slot));
+        }
+        // Cumulative rounding keeps the total exact; producer 0 holds rank 1
+        // and so the largest share, which covers the 1 msg/s floor of the rest
+        const double total_mass = std::accumulate(mass.begin(), mass.end(), 0.0);
+        double mass_below = 0.0;
+        for (size_t p = 0; p < producer_count; ++p) {
+            const auto before = static_cast<uint64_t>(msgs_per_sec * mass_below / total_mass);
+            mass_below += mass[p];
+            const auto upto = p + 1 == producer_count ? msgs_per_sec
+                                                      : static_cast<uint64_t>(msgs_per_sec * mass_below / total_mass);
+            producers[p]->target_rate = upto - before;
+        }
+        for (size_t p = 1; p < producer_count; ++p) {
+            if (producers[p]->target_rate == 0) {
+                producers[p]->target_rate = 1;
+                --producers[0]->target_rate;
+            }
+        }
+        if (price_walk) {
+            size_t bytes = 0;
+            for (auto& p : producers) bytes += p->quotes->memory_bytes();
+            std::cout << "[INFO] Quote model: " << universe << " symbol books, " << bytes / 1024 << " KB\n";
+        }
+
+        // Optional pre-generated corpus: content is built (or loaded) now, so
+        // the producers only stamp and publish during the run
+        size_t corpus_total = 0;
+        if (!corpus_file.empty()) {
+            const MessageCorpus& corpus = producers[0]->corpus.emplace(MessageCorpus::load(corpus_file));
+            if (corpus.max_symbol() > universe) {
+                throw std::invalid_argument("corpus " + corpus_file + " has symbol ids up to " +
+                                            std::to_string(corpus.max_symbol()) + "; set --universe to match");
+            }
+            std::cout << "[INFO] Corpus: " << corpus.size() << " messages loaded from " << corpus_file;
+        } else if (corpus_msgs) {
+            const auto t0 = std::chrono::steady_clock::now();
+            for (auto& p : producers) {
+                MessageCorpus& corpus = p->corpus.emplace(std::max<size_t>(corpus_msgs / producer_count, 1));
+                generate_messages(corpus.data(), corpus.size(), p->cfg);
+            }
+            std::cout << "[INFO] Corpus: " << producers[0]->corpus->size() * producer_count
+                      << " messages generated in " << std::fixed << std::setprecision(2)
+                      << std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() << " s";
+        }
+        if (producers[0]->corpus) {
+            size_t bytes = 0;
+            for (auto& p : producers) {
+                p->cfg.corpus = p->corpus->data();
+                p->cfg.corpus_size = p->corpus->size();
+                corpus_total += p->corpus->size();
+                bytes += p->corpus->bytes();
+            }
+            std::cout << " (" << (bytes >> 20) << " MB, " << producers[0]->corpus->backing_name() << ")\n";
+            if (!corpus_save.empty()) {
+                producers[0]->corpus->save(corpus_save);
+                std::cout << "[INFO] Corpus saved to " << corpus_save << "\n";
+            }
+        }
+
+        // Optional per-symbol breakdown; symbols are routed to one shard each,
+        // so the shard recorders just add up
+        if (symbol_top) {
+            for (auto& s : shards) {
+                s->symbols = std::make_unique<SymbolStats>(universe + 1, kSymbolHistograms);
+            }
+            std::cout << "[INFO] Per-symbol recorders: " << shards[0]->symbols->memory_bytes() / 1024
+                      << " KB per shard\n";
+        }
 
-        // Pre-allocate latency collection vector
+        // Optional raw samples for exact percentiles, split across shards
+        // (stratified: an equal share of every second of the run)
         std::vector<uint64_t> latencies;
-        size_t max_samples = msgs_per_sec * total_seconds / 2;
-        latencies.reserve(max_samples);
-        std::cout << "[INFO] Reserved space for " << max_samples << " latency samples\n";
+        const size_t raw_per_shard = (raw_samples + shard_count - 1) / shard_count;
+        const size_t strata = sampling == LatencySampler::Mode::Stratified ? total_seconds : 1;
+        const size_t per_stratum = std::max<size_t>(raw_per_shard / strata, 1);
+        if (raw_samples) {
+            const uint64_t t_start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            for (size_t i = 0; i < shard_count; ++i) {
+                shards[i]->sampler = std::make_unique<LatencySampler>(
+                    sampling, per_stratum, strata, t_start_ns, 1'000'000'000ULL, 0x9E3779B97F4A7C15ULL + i);
+            }
+            std::cout << "[INFO] Reserved space for " << per_stratum * strata * shard_count << " raw latency samples\n";
+        }
+
+        // Optional flight recorder: one ring per pipeline thread, all added
+        // before any thread starts
+        std::unique_ptr<FlightRecorder> flight;
+        if (flight_events) {
+            flight = std::make_unique<FlightRecorder>(flight_events, flight_prefix, flight_dumps);
+            flight->set_latency_trigger(flight_latency_us * 1000);
+            flight->set_gap_trigger(flight_gap);
+#ifdef SIGUSR1
+            signal(SIGUSR1, sigusr1_handler);
+#endif
+            std::cout << "[INFO] Flight recorder: last " << flight_events << " events per thread ("
+                      << (shard_count + producer_count) * flight_events * sizeof(FlightRecord) / 1024
+                      << " KB), dumps to "
+                      << flight_prefix << "-N.bin\n";
+        }
 
         // Launch producer and consumer threads
         std::cout << "[INFO] Starting producer and consumer threads...\n\n";
-        std::thread prod([&]{ 
-            producer_thread_func(q, g_run, msgs_per_sec); 
-        });
+        const std::string generator_name =
+            producers[0]->corpus ? "corpus replay"
+            : batch_rng ? (BatchRng::vectorized() ? "xoshiro256** x4, AVX2" : "xoshiro256** x4, scalar")
+                        : "mt19937_64";
+        const std::string traffic_name = traffic.spec() + (poisson ? "+poisson" : "");
+        PerfCounters prod_perf;
+        for (size_t p = 0; p < producer_count; ++p) {
+            ProducerSlot& slot = *producers[p];
+            ProducerConfig& c = slot.cfg;
+            c.target_msgs_per_sec = slot.target_rate;
+            c.line_b = line_b.get();
+            c.line_loss_ppm = line_loss_ppm;
+            c.produced = producer_count == 1 ? &produced : &slot.produced;
+            c.stamp_intended = co_intended;
+            c.skip_stalled = co_backfill;
+            c.pacing = pacing;
+            c.spin_ns = spin_us * 1000;
+            c.pacing_stats = &slot.pacing;
+            c.traffic = &traffic;
+            c.poisson = poisson;
+            c.generator_stats = &slot.generator;
+            c.tracer = tracer.get();
+            c.flight = flight ? &flight->add_ring(producer_count == 1 ? "producer" : "producer" + std::to_string(p))
+                              : nullptr;
+            if (track_stalls) {
+                slot.stalls = std::make_unique<StallRing>(stall_slots, producer_count);
+                c.stalls = slot.stalls.get();
+            }
+            if (p == 0) {
+                // Perf counters have one writer: the first producer
+                c.perf = use_perf ? &prod_perf : nullptr;
+                if (shard_count > 1) {
+                    for (auto& s : shards) c.shards.push_back(&s->queue);
+                }
+            } else {
+                for (auto& s : shards) {
+                    s->inputs.push_back(std::make_unique<SPSCQueue<RawMsg>>(buf_pow2));
+                    c.shards.push_back(s->inputs.back().get());
+                }
+            }
+        }
+        for (auto& slot : producers) {
+            slot->thread = std::thread([&, p = slot.get()] {
+                producer_thread_func(ab_lines ? *line_a : q, g_run, p->cfg);
+            });
+        }
+        auto total_produced = [&] {
+            uint64_t n = produced.load(std::memory_order_relaxed);
+            for (auto& p : producers) n += p->produced.load(std::memory_order_relaxed);
+            return n;
+        };
+
+        std::thread arb;
+        if (ab_lines) {
+            arb = std::thread([&]{
+                arbiter_thread_func(*line_a, *line_b, q, g_run, arb_window, arb_stats, metrics);
+            });
+        }
         
-        std::thread cons([&]{ 
-            consumer_thread_func(q, g_run, latencies, max_samples); 
-        });
+        std::unique_ptr<ReorderWindow> reorder;
+        if (reorder_slots) {
+            reorder = std::make_unique<ReorderWindow>(reorder_slots, reorder_timeout_us * 1000);
+        }
+
+        for (size_t i = 0; i < shard_count; ++i) {
+            ConsumerShard& s = *shards[i];
+            ConsumerContext& ctx = s.ctx;
+            ctx.histogram = use_hdr ? &s.histogram : nullptr;
+            ctx.sketch = use_sketch ? &s.sketch : nullptr;
+            ctx.sampler = s.sampler.get();
+            ctx.intervals = &s.intervals;
+            ctx.backfill_stalls = co_backfill;
+            ctx.delivered = metrics ? &metrics->consumed : &s.delivered;
+            ctx.outliers = s.outliers.get();
+            ctx.stalls = producers[0]->stalls.get();
+            ctx.perf = use_perf ? &s.perf : nullptr;
+            ctx.symbols = s.symbols.get();
+            for (size_t in = 0; in < s.inputs.size(); ++in) {
+                ctx.inputs.push_back(s.inputs[in].get());
+                if (track_stalls) ctx.input_stalls.push_back(producers[in + 1]->stalls.get());
+            }
+            if (flight) {
+                ctx.flight = &flight->add_ring("consumer" + std::to_string(i));
+                ctx.flight_recorder = flight.get();
+                ctx.flight_gaps = shard_count == 1 && producer_count == 1;
+            }
+            if (i == 0) {
+                ctx.reorder = reorder.get();
+                ctx.tracer = tracer.get();
+                ctx.metrics = metrics;
+            }
+            s.thread = std::thread([&s]{
+                consumer_thread_func(s.queue, g_run, s.ctx);
+            });
+        }
 
         // Monitor execution and display progress
         std::cout << "========================================\n";
         std::cout << "Benchmark Running...\n";
         std::cout << "========================================\n";
         
-        using namespace std::chrono_literals;
-        for (int i = 0; i < total_seconds && g_run.load(std::memory_order_acquire); ++i) {
-            std::this_thread::sleep_for(1s);
-            size_t approx = q.approx_size();
-            std::cout << "[t=" << std::setw(3) << (i + 1) << "s] Queue depth: " 
-                     << std::setw(8) << approx << " messages\n";
+        // Each interval: close every shard's histogram, merge them and sample the counters
+        const auto run_start = std::chrono::steady_clock::now();
+        const auto run_end = run_start + std::chrono::seconds(total_seconds);
+        const auto interval = std::chrono::milliseconds(interval_ms);
+        auto last_tick = run_start;
+        uint64_t last_produced = 0;
+        uint64_t last_delivered = 0;
+        PerfSnapshot perf_warm;           // counters at the end of the first interval
+        bool perf_after_warmup = false;
+        auto write_flight_dump = [&] {
+            std::string path = flight->write_pending();
+            if (!path.empty()) std::cout << "[INFO] Flight recorder dump written to " << path << "\n";
+        };
+        while (last_tick < run_end && g_run.load(std::memory_order_acquire)) {
+            auto tick = std::min(last_tick + interval, run_end);
+            std::this_thread::sleep_until(tick);
+            interval_merged.reset();
+            bool have_latency = true;
+            for (auto& s : shards) {
+                // Wait for every shard: a shard that missed a rotation would hand
+                // over two intervals in the next row. A consumer acknowledges on
+                // its next record or idle poll, so only descheduling delays it;
+                // give up only once the run is stopping.
+                const LatencyHistogram* h = nullptr;
+                while (!(h = s->intervals.rotate(std::chrono::milliseconds(50))) &&
+                       g_run.load(std::memory_order_acquire)) {
+                }
+                if (h) {
+                    interval_merged.merge(*h);
+                } else {
+                    have_latency = false;
+                }
+            }
+            auto now = std::chrono::steady_clock::now();
+
+            IntervalSample row;
+            row.t_s = std::chrono::duration<double>(now - run_start).count();
+            row.length_s = std::chrono::duration<double>(now - last_tick).count();
+            uint64_t prod_total = total_produced();
+            row.produced = prod_total - last_produced;
+            uint64_t cons_total = 0;
+            for (auto& s : shards) {
+                cons_total += s->ctx.delivered->load(std::memory_order_relaxed);
+                row.depth += s->queue.approx_size();
+                for (auto& in : s->inputs) row.depth += in->approx_size();
+            }
+            row.consumed = cons_total - last_delivered;
+            // The first interval is warm-up; counters are reported from here on
+            if (use_perf && series.empty() && tick < run_end) {
+                perf_warm = take_perf_snapshot(prod_perf, shards, prod_total, cons_total);
+                perf_after_warmup = true;
+            }
+            if (metrics) {
+                MetricsRegion& r = *metrics;
+                r.queue_depth.store(row.depth, std::memory_order_relaxed);
+                r.heartbeat_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    now.time_since_epoch()).count(), std::memory_order_relaxed);
+            }
+            if (have_latency) {
+                row.p50 = interval_merged.value_at_quantile(0.50);
+                row.p90 = interval_merged.value_at_quantile(0.90);
+                row.p99 = interval_merged.value_at_quantile(0.99);
+                row.p999 = interval_merged.value_at_quantile(0.999);
+                row.max = interval_merged.max();
+            }
+            series.push_back(row);
+            print_interval(row, have_latency);
+            if (flight) {
+                if (g_flight_signal.exchange(false, std::memory_order_relaxed)) {
+                    flight->trigger(FlightTrigger::Signal, 0, 0, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        now.time_since_epoch()).count());
+                }
+                write_flight_dump();
+            }
+            last_produced = prod_total;
+            last_delivered = cons_total;
+            last_tick = now;
         }
 
         // Signal threads to stop and wait for completion
         std::cout << "\n[INFO] Stopping threads...\n";
         g_run.store(false, std::memory_order_release);
+        if (metrics) metrics->running.store(0, std::memory_order_relaxed);
         
-        prod.join();
-        cons.join();
+        for (auto& p : producers) p->thread.join();
+        if (arb.joinable()) arb.join();
+        for (auto& s : shards) s->thread.join();
+        if (flight) write_flight_dump();
+        const double run_seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - run_start).count();
+        PerfSnapshot perf_steady;
+        if (use_perf) {
+            uint64_t cons_total = 0;
+            for (auto& s : shards) cons_total += s->ctx.delivered->load(std::memory_order_relaxed);
+            perf_steady = take_perf_snapshot(prod_perf, shards, total_produced(), cons_total) - perf_warm;
+        }
         
         std::cout << "[INFO] All threads stopped successfully\n";
 
+        // All producers together; the per-producer rates are listed separately
+        PacingStats pacing_stats(hdr_digits);
+        GeneratorStats generator_stats;
+        for (auto& p : producers) {
+            pacing_stats.merge(p->pacing);
+            generator_stats.messages += p->generator.messages;
+            generator_stats.ns += p->generator.ns;
+        }
+
+        // Exact merge of the per-shard recorders
+        for (auto& s : shards) {
+            histogram.merge(s->histogram);
+            sketch.merge(s->sketch);
+        }
+        if (raw_samples) {
+            std::vector<const LatencySampler*> parts;
+            for (auto& s : shards) parts.push_back(s->sampler.get());
+            latencies = merge_samples(parts);
+        }
+        std::vector<SymbolSummary> symbols_by_volume;
+        std::vector<SymbolSummary> symbols_by_p99;
+        // Shards see disjoint symbols, so the merged pool holds all their histograms
+        std::unique_ptr<SymbolStats> symbols_all;
+        if (symbol_top) {
+            symbols_all = std::make_unique<SymbolStats>(universe + 1, kSymbolHistograms * shard_count);
+            for (auto& s : shards) symbols_all->merge(*s->symbols);
+            symbols_by_volume = symbols_all->top_by_volume(symbol_top);
+            symbols_by_p99 = symbols_all->top_by_p99(symbol_top);
+        }
+        std::vector<Outlier> outliers;
+        if (outlier_count) {
+            for (size_t i = 1; i < shard_count; ++i) shards[0]->outliers->merge(*shards[i]->outliers);
+            outliers = shards[0]->outliers->sorted();
+        }
+        const uint64_t run_start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            run_start.time_since_epoch()).count();
+
         // Display results
         std::cout << "\n========================================\n";
         std::cout << "Benchmark Complete\n";
         std::cout << "========================================\n";
-        std::cout << "Total samples collected: " << latencies.size() << "\n";
+        std::cout << "Total samples collected: " << (use_hdr ? histogram.count() : sketch.count()) << "\n";
         
         // Print detailed statistics
-        print_stats(latencies);
+        if (use_hdr) {
+            print_stats(histogram);
+        }
+        if (use_sketch) {
+            std::cout << "\nDDSketch (" << (sketch_accuracy * 100.0) << "% relative accuracy):";
+            print_stats(sketch);
+        }
+        if (raw_samples) {
+            const size_t n = latencies.size();
+            if (sampling == LatencySampler::Mode::First) {
+                std::cout << "\nExact percentiles over the first " << n << " samples:";
+            } else if (sampling == LatencySampler::Mode::Reservoir) {
+                std::cout << "\nExact percentiles over a uniform sample of " << n << " latencies:";
+            } else {
+                std::cout << "\nExact percentiles over " << n << " samples, an equal share per second:";
+            }
+            print_stats(latencies);
+        }
+
+        // Point at the interval where the tail was worst
+        auto worst = std::max_element(series.begin(), series.end(),
+            [](const IntervalSample& a, const IntervalSample& b) { return a.p999 < b.p999; });
+        if (worst != series.end() && worst->consumed) {
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "Worst interval:    t=" << worst->t_s << "s (p99.9 " << worst->p999 / 1000.0
+                      << " μs, max " << worst->max / 1000.0 << " μs)\n";
+        }
+
+        print_pacing_stats(pacing_stats, msgs_per_sec,
+                           co_intended && pacing == PacingMode::Sleep ? PacingMode::Absolute : pacing, traffic_name,
+                           generator_stats, generator_name);
+        if (producer_count > 1) {
+            print_producer_stats(producers);
+        }
+        if (shard_count > 1) {
+            print_shard_stats(shards, use_hdr);
+        }
+        if (ab_lines) {
+            print_arbiter_stats(arb_stats);
+        }
+        if (reorder) {
+            print_reorder_stats(reorder->stats());
+        }
+        if (tracer) {
+            print_trace_stats(*tracer);
+        }
+        if (outlier_count) {
+            print_outliers(outliers, run_start_ns);
+        }
+        if (symbol_top) {
+            print_symbol_stats(symbols_by_volume, symbols_by_p99, symbols_all->active(), run_seconds);
+        }
+        if (use_perf) {
+            std::string why = prod_perf.error();
+            for (auto& s : shards) {
+                if (why.empty()) why = s->perf.error();
+            }
+            print_perf_stats(perf_steady, perf_after_warmup, why);
+        }
+
+        // Machine-readable reports for performance tracking
+        if (!json_path.empty() || !csv_path.empty()) {
+            RunReport report;
+            report.config = {
+                {"msgs_per_sec", std::to_string(msgs_per_sec)},
+                {"total_seconds", std::to_string(total_seconds)},
+                {"buffer_size", std::to_string(buf_pow2)},
+                {"ab", ab_lines ? "on" : "off"},
+                {"line_loss_ppm", std::to_string(line_loss_ppm)},
+                {"arb_window", std::to_string(arb_window)},
+                {"reorder_slots", std::to_string(reorder_slots)},
+                {"reorder_timeout_us", std::to_string(reorder_timeout_us)},
+                {"hdr_digits", std::to_string(hdr_digits)},
+                {"raw_samples", std::to_string(raw_samples)},
+                {"sampling", sampling == LatencySampler::Mode::First ? "first"
+                             : sampling == LatencySampler::Mode::Reservoir ? "reservoir" : "stratified"},
+                {"recorder", use_hdr && use_sketch ? "both" : use_hdr ? "hdr" : "ddsketch"},
+                {"sketch_accuracy", std::to_string(sketch_accuracy)},
+                {"interval_ms", std::to_string(interval_ms)},
+                {"co", co_intended ? "intended" : co_backfill ? "backfill" : "off"},
+                {"trace_every", std::to_string(trace_every)},
+                {"shards", std::to_string(shard_count)},
+                {"outliers", std::to_string(outlier_count)},
+                {"perf", use_perf ? "on" : "off"},
+                {"symbols", std::to_string(symbol_top)},
+                {"flight", std::to_string(flight_events)},
+                {"pacing", pacing_name(pacing)},
+                {"spin_us", std::to_string(spin_us)},
+                {"traffic", traffic.spec()},
+                {"arrivals", poisson ? "poisson" : "uniform"},
+                {"universe", std::to_string(universe)},
+                {"zipf", std::to_string(zipf)},
+                {"prices", price_walk ? "walk" : "uniform"},
+                {"rng", batch_rng ? "batch" : "mt19937"},
+                {"seed", std::to_string(seed)},
+                {"corpus", std::to_string(corpus_total)},
+                {"producers", std::to_string(producer_count)},
+            };
+            report.host = collect_host_info();
+            report.duration_s = run_seconds;
+            report.produced = total_produced();
+            for (auto& s : shards) report.consumed += s->ctx.delivered->load(std::memory_order_relaxed);
+            report.histogram = use_hdr ? &histogram : nullptr;
+            report.series = &series;
+            report.outliers = outlier_count ? &outliers : nullptr;
+            report.t_start_ns = run_start_ns;
+            if (use_perf) report.perf = perf_per_message(perf_steady);
+            report.pacing = pacing_summary(pacing_stats, msgs_per_sec, generator_stats);
+            if (producer_count > 1) {
+                for (size_t i = 0; i < producer_count; ++i) {
+                    const std::string key = "producer" + std::to_string(i);
+                    report.pacing.emplace_back(key + "_target_rate", static_cast<double>(producers[i]->target_rate));
+                    report.pacing.emplace_back(key + "_achieved_rate", producers[i]->pacing.achieved_rate());
+                }
+            }
+            if (symbol_top) {
+                report.symbols_by_volume = &symbols_by_volume;
+                report.symbols_by_p99 = &symbols_by_p99;
+            }
+
+            auto write = [&](const std::string& path, auto writer) {
+                std::ofstream out(path);
+                if (out) writer(out, report);
+                if (!out) throw std::runtime_error("cannot write report " + path);
+                std::cout << "[INFO] Report written to " << path << "\n";
+            };
+            if (!json_path.empty()) write(json_path, write_json);
+            if (!csv_path.empty()) write(csv_path, write_csv);
+        }
 
         return 0;
 
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file outlier_tracker.h
+ * @brief Worst-K latency outliers with per-message context
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Percentiles say that the tail is bad; the individual outliers say why.
+ * The consumer keeps the K slowest messages together with the queue depth,
+ * the producer-side stall and the CPU it ran on, so each outlier can be
+ * matched to a burst, a backpressure stall or a migration.
+ */
+
+/**
+ * @struct Outlier
+ * @brief One slow message and the context it was delivered in
+ */
+struct Outlier {
+    uint64_t latency_ns = 0;         ///< End-to-end latency
+    uint64_t seq = 0;                ///< Message sequence number
+    uint64_t t_recv_ns = 0;          ///< Consumer receive time (steady clock)
+    uint64_t queue_depth = 0;        ///< Consumer queue depth when delivered
+    uint64_t producer_stall_ns = 0;  ///< Time the producer was held up sending it
+    uint32_t symbol_id = 0;          ///< Instrument
+    int cpu = -1;                    ///< CPU the consumer ran on (-1 = unknown)
+};
+
+/**
+ * @class StallRing
+ * @brief Seq-indexed record of producer stalls, written only when one occurs
+ *
+ * The producer stores the stall of message seq (time spent waiting for queue
+ * space, or with intended-time stamping a lateness of a period or more
+ * against its schedule) in slot (seq / stride) & (size - 1), tagged with
+ * seq, together with the mean send gap in effect at the time, which tells a
+ * reader how many sends the stall hid. Messages that went out without a
+ * stall cost nothing. A
+ * lookup whose tag does not match reports 0: either there was no stall, or
+ * the slot has since been reused by a later stall. A ring with at least as
+ * many slots as the producer can have messages in flight keeps every stall
+ * until the consumer reaches its message.
+ *
+ * @note One writer thread; any number of reader threads.
+ */
+class StallRing {
+public:
+    /// @brief One recorded stall
+    struct Stall {
+        uint64_t stall_ns = 0;  ///< Time the producer was held up (0 = none recorded)
+        uint64_t gap_ns = 0;    ///< Mean send gap in effect when it happened (0 = unknown)
+    };
+
+    /**
+     * @param size Number of slots (power of two)
+     * @param stride Step between the writer's sequence numbers (producers
+     *               sharing the sequence space), so no slot goes unused
+     * @throws std::invalid_argument if size is not a power of two or stride is 0
+     */
+    explicit StallRing(size_t size = 65536, uint64_t stride = 1)
+        : mask_(size - 1), stride_(stride), slots_(std::make_unique<Slot[]>(size)) {
+        if (!std::has_single_bit(size)) throw std::invalid_argument("stall ring size must be a power of two");
+        if (stride == 0) throw std::invalid_argument("stall ring stride must be at least 1");
+    }
+
+    /// @brief Records a stall of message @p seq and the send gap in effect (producer thread)
+    void record(uint64_t seq, uint64_t stall_ns, uint64_t gap_ns = 0) noexcept {
+        Slot &s = slots_[(seq / stride_) & mask_];
+        // Invalidate the tag first, so no reader pairs the old tag with the new values
+        s.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.stall_ns.store(stall_ns, std::memory_order_relaxed);
+        s.gap_ns.store(gap_ns, std::memory_order_relaxed);
+        s.seq.store(seq, std::memory_order_release);
+    }
+
+    /// @brief Stall of message @p seq, or an empty Stall if none is recorded
+    Stall find(uint64_t seq) const noexcept {
+        const Slot &s = slots_[(seq / stride_) & mask_];
+        if (s.seq.load(std::memory_order_acquire) != seq) return {};
+        const Stall v{s.stall_ns.load(std::memory_order_relaxed), s.gap_ns.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return s.seq.load(std::memory_order_relaxed) == seq ? v : Stall{};
+    }
+
+    /// @brief Stall time of message @p seq, or 0 if none is recorded
+    uint64_t lookup(uint64_t seq) const noexcept { return find(seq).stall_ns; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> stall_ns{0};
+        std::atomic<uint64_t> gap_ns{0};
+    };
+
+    size_t mask_;
+    uint64_t stride_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+/**
+ * @class OutlierTracker
+ * @brief Fixed-size min-heap of the K worst latencies
+ *
+ * The hot path is a single comparison against threshold(), the smallest
+ * latency still in the heap; only messages above it pay for collecting
+ * context and an O(log K) heap replacement. Storage is allocated once.
+ *
+ * @note Not thread-safe. One tracker belongs to one consumer thread;
+ *       per-shard trackers are combined with merge().
+ */
+class OutlierTracker {
+public:
+    /**
+     * @param k Number of outliers to keep (>= 1)
+     * @throws std::invalid_argument if k is 0
+     */
+    explicit OutlierTracker(size_t k) : k_(k) {
+        if (k == 0) throw std::invalid_argument("outlier count must be at least 1");
+        heap_.reserve(k);
+    }
+
+    /// @brief Latencies at or below this value cannot enter the heap
+    uint64_t threshold() const noexcept {
+        return threshold_;
+    }
+
+    /**
+     * @brief Adds @p o if it is among the K worst seen so far
+     */
+    void offer(const Outlier &o) {
+        if (heap_.size() < k_) {
+            heap_.push_back(o);
+            std::push_heap(heap_.begin(), heap_.end(), worse);
+        } else if (o.latency_ns > heap_.front().latency_ns) {
+            std::pop_heap(heap_.begin(), heap_.end(), worse);
+            heap_.back() = o;
+            std::push_heap(heap_.begin(), heap_.end(), worse);
+        }
+        if (heap_.size() == k_) threshold_ = heap_.front().latency_ns;
+    }
+
+    /// @brief Offers every outlier held by @p other
+    void merge(const OutlierTracker &other) {
+        for (const Outlier &o : other.heap_) offer(o);
+    }
+
+    /// @brief Outliers, worst first
+    std::vector<Outlier> sorted() const {
+        std::vector<Outlier> out = heap_;
+        std::sort(out.begin(), out.end(),
+                  [](const Outlier &a, const Outlier &b) { return a.latency_ns > b.latency_ns; });
+        return out;
+    }
+
+    /// @brief Configured K
+    size_t capacity() const noexcept {
+        return k_;
+    }
+
+private:
+    // Heap order: the smallest latency on top
+    static bool worse(const Outlier &a, const Outlier &b) noexcept {
+        return a.latency_ns > b.latency_ns;
+    }
+
+    size_t k_;
+    uint64_t threshold_ = 0;
+    std::vector<Outlier> heap_;
+};
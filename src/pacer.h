@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#include "hdr_histogram.h"
+#include "traffic_profile.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file pacer.h
+ * @brief Absolute-deadline send pacing for the producer
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Sleeping for one period after every message cannot reach high rates: at
+ * 500K msgs/s the period is 2 μs while a sleep takes 50 μs or more, and
+ * every oversleep is lost for good. The Pacer instead gives message n the
+ * deadline start + n * period on the monotonic clock. It waits only while
+ * the deadline lies ahead, so after a slow stretch the overdue messages go
+ * out back to back (a catch-up batch) until the schedule is met again, and
+ * the average rate is exact. In Spin mode the last stretch before each
+ * deadline is busy-waited, which trades a core for sub-microsecond send
+ * times.
+ *
+ * The gap to the next deadline follows the rate a TrafficProfile gives for
+ * the current deadline, and with Poisson arrivals it is drawn from the
+ * exponential distribution with that mean instead of being fixed.
+ */
+
+/**
+ * @enum PacingMode
+ * @brief How the producer waits between messages
+ */
+enum class PacingMode {
+    Sleep,     ///< Sleep one period after each message (relative; drifts below the target rate)
+    Absolute,  ///< Sleep until each message's deadline; catch up when behind
+    Spin       ///< Absolute deadlines, busy-waiting the last spin_ns before each
+};
+
+/**
+ * @struct PacingStats
+ * @brief What the producer's schedule actually looked like
+ *
+ * Written by the producer thread only; read after it has been joined.
+ */
+struct PacingStats {
+    explicit PacingStats(int significant_digits = 3)
+        : intervals(10'000'000'000ULL, significant_digits), lateness(10'000'000'000ULL, significant_digits) {}
+
+    LatencyHistogram intervals;  ///< Time between consecutive sends (inter-arrival)
+    LatencyHistogram lateness;   ///< Send time minus deadline (absolute modes)
+    uint64_t sent = 0;           ///< Messages sent
+    uint64_t catch_up = 0;       ///< Messages sent a base period or more after their deadline
+    uint64_t first_ns = 0;       ///< First send (steady clock)
+    uint64_t last_ns = 0;        ///< Last send (steady clock)
+    uint64_t first_slot_ns = 0;  ///< First deadline (absolute modes)
+    uint64_t last_slot_ns = 0;   ///< Last deadline (absolute modes)
+
+    /**
+     * @brief Adds another producer's statistics
+     *
+     * The rates of the merged statistics are those of all producers
+     * together, between the earliest and the latest send.
+     */
+    void merge(const PacingStats &other) {
+        if (!other.sent) return;
+        intervals.merge(other.intervals);
+        lateness.merge(other.lateness);
+        catch_up += other.catch_up;
+        if (!sent || other.first_ns < first_ns) first_ns = other.first_ns;
+        if (!sent || other.first_slot_ns < first_slot_ns) first_slot_ns = other.first_slot_ns;
+        last_ns = std::max(last_ns, other.last_ns);
+        last_slot_ns = std::max(last_slot_ns, other.last_slot_ns);
+        sent += other.sent;
+    }
+
+    /// @brief Messages per second between the first and last send
+    double achieved_rate() const noexcept {
+        return last_ns > first_ns ? (sent - 1) * 1e9 / (last_ns - first_ns) : 0.0;
+    }
+
+    /// @brief Messages per second the schedule asked for over the same messages
+    double scheduled_rate() const noexcept {
+        return last_slot_ns > first_slot_ns ? (sent - 1) * 1e9 / (last_slot_ns - first_slot_ns) : 0.0;
+    }
+};
+
+/**
+ * @brief Spin-loop hint (PAUSE on x86)
+ */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @class Pacer
+ * @brief Waits for each message's send slot
+ *
+ * @note Not thread-safe; one pacer belongs to the producer thread.
+ */
+class Pacer {
+public:
+    /**
+     * @param period_ns Nanoseconds between messages at the base rate (0 = unpaced)
+     * @param mode Waiting strategy
+     * @param spin_ns Busy-wait window before each deadline (Spin mode)
+     * @param start_ns Deadline of the first message (steady clock)
+     * @param profile Rate over time (nullptr = the base rate throughout); must outlive the pacer
+     * @param poisson Exponentially distributed gaps instead of fixed ones
+     * @param seed Seed of the gap draws
+     */
+    Pacer(uint64_t period_ns, PacingMode mode, uint64_t spin_ns, uint64_t start_ns,
+          const TrafficProfile *profile = nullptr, bool poisson = false, uint64_t seed = 1) noexcept
+        : period_ns_(period_ns), mode_(mode), spin_ns_(spin_ns), start_ns_(start_ns), profile_(profile),
+          poisson_(poisson), rng_(seed ? seed : 1) {}
+
+    /**
+     * @brief Waits until the next message may be sent
+     *
+     * @return Its deadline, or the current time in Sleep mode and when
+     *         unpaced (no schedule)
+     */
+    uint64_t wait() noexcept {
+        if (period_ns_ == 0) return now_ns();
+        if (started_) {
+            gap_ns_ = next_gap();
+            offset_ns_ += gap_ns_;
+        }
+        started_ = true;
+        if (mode_ == PacingMode::Sleep) {
+            if (gap_ns_ > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<uint64_t>(gap_ns_)));
+            return now_ns();
+        }
+        const uint64_t deadline = start_ns_ + static_cast<uint64_t>(offset_ns_);
+        uint64_t now = now_ns();
+        if (now >= deadline) return deadline;  // behind: catch up without waiting
+        const uint64_t spin = mode_ == PacingMode::Spin ? spin_ns_ : 0;
+        if (deadline - now > spin) {
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(deadline - spin)));
+        }
+        if (mode_ == PacingMode::Spin) {
+            while (now_ns() < deadline) cpu_relax();
+        }
+        return deadline;
+    }
+
+    /**
+     * @brief Moves the schedule @p ns later
+     *
+     * The messages due in that time are dropped from the schedule instead of
+     * being caught up on, for example when the stall that delayed them is
+     * back-filled downstream.
+     */
+    void skip(uint64_t ns) noexcept { offset_ns_ += static_cast<double>(ns); }
+
+    /// @brief True if send times follow a fixed schedule
+    bool scheduled() const noexcept { return period_ns_ && mode_ != PacingMode::Sleep; }
+
+    /// @brief Gap before the current message (0 for the first)
+    uint64_t gap_ns() const noexcept { return static_cast<uint64_t>(gap_ns_); }
+
+    /**
+     * @brief Mean gap between sends at the current point of the schedule
+     *
+     * The base period scaled by the traffic profile; Poisson gaps average to
+     * it. A stall of T hides about T / mean_gap_ns() sends.
+     */
+    uint64_t mean_gap_ns() const noexcept { return static_cast<uint64_t>(mean_gap()); }
+
+    static uint64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    double mean_gap() const noexcept {
+        double gap = static_cast<double>(period_ns_);
+        // At most a 1e6 x slowdown, so an idle stretch of a curve cannot stall the schedule forever
+        if (profile_) gap /= std::max(profile_->multiplier(static_cast<uint64_t>(offset_ns_)), 1e-6);
+        return gap;
+    }
+
+    double next_gap() noexcept {
+        double gap = mean_gap();
+        if (poisson_) {
+            rng_ ^= rng_ >> 12;
+            rng_ ^= rng_ << 25;
+            rng_ ^= rng_ >> 27;
+            const double u = (static_cast<double>((rng_ * 0x2545F4914F6CDD1DULL) >> 11) + 0.5) *
+                             (1.0 / 9007199254740992.0);  // (0, 1)
+            gap *= -std::log(u);
+        }
+        return gap;
+    }
+
+    uint64_t period_ns_;
+    PacingMode mode_;
+    uint64_t spin_ns_;
+    uint64_t start_ns_;
+    const TrafficProfile *profile_;
+    bool poisson_;
+    uint64_t rng_;             // xorshift64* state for Poisson gaps
+    bool started_ = false;
+    double offset_ns_ = 0.0;   // current deadline minus start_ns_ (double: no truncation drift)
+    double gap_ns_ = 0.0;
+};
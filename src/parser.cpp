@@ -1,23 +1,76 @@
 #include "parser.h"
 #include "spsc_ringbuffer.h"
+#include "stage_trace.h"
 #include <chrono>
 #include <atomic>
 #include <vector>
 #include <thread>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 using namespace std::chrono;
 
+namespace {
+
+inline uint64_t now_ns() noexcept {
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Reorder drops and gaps for live monitoring (consumer thread)
+inline void publish_reorder(const ConsumerContext &ctx) noexcept {
+    if (!ctx.metrics || !ctx.reorder) return;
+    const ReorderStats &st = ctx.reorder->stats();
+    ctx.metrics->reorder_late.store(st.late, std::memory_order_relaxed);
+    ctx.metrics->reorder_skipped.store(st.skipped, std::memory_order_relaxed);
+}
+
+inline int current_cpu() noexcept {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+}  // namespace
+
 void consumer_thread_func(SPSCQueue<RawMsg> &q, std::atomic<bool> &run_flag,
                           std::vector<uint64_t> &latencies_ns, size_t max_collect) {
-    RawMsg m;
-    while (run_flag.load(std::memory_order_relaxed)) {
-        if (!q.try_pop(m)) {
-            std::this_thread::yield();
-            continue;
+    ConsumerContext ctx;
+    ctx.latencies_ns = &latencies_ns;
+    ctx.max_collect = max_collect;
+    consumer_thread_func(q, run_flag, ctx);
+}
+
+void consumer_thread_func(SPSCQueue<RawMsg> &q, std::atomic<bool> &run_flag, ConsumerContext &ctx) {
+    if (ctx.perf) ctx.perf->open();
+    uint64_t t_recv = 0;
+    uint64_t delivered = 0;
+    uint64_t last_seq = 0;  // highest delivered, for gap events
+    uint32_t batch = 0;     // messages popped since the queue was last empty
+    SPSCQueue<RawMsg> *from = &q;               // queue of the last pop
+    const StallRing *from_stalls = ctx.stalls;  // stalls of its producer
+    size_t next_input = 0;                      // round-robin position over q and ctx.inputs
+    auto pop = [&](RawMsg &out) {
+        if (ctx.inputs.empty()) return q.try_pop(out);
+        const size_t n = ctx.inputs.size() + 1;
+        for (size_t k = 0; k < n; ++k) {
+            if (next_input == 0) {
+                from = &q;
+                from_stalls = ctx.stalls;
+            } else {
+                from = ctx.inputs[next_input - 1];
+                from_stalls = ctx.input_stalls.empty() ? nullptr : ctx.input_stalls[next_input - 1];
+            }
+            if (++next_input == n) next_input = 0;
+            if (from->try_pop(out)) return true;
         }
-        uint64_t t_recv = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
-        uint64_t latency = t_recv - m.t_sent_ns;
-        if (latencies_ns.size() < max_collect) latencies_ns.push_back(latency);
+        return false;
+    };
+    auto deliver = [&](const RawMsg &m) {
+        if (ctx.delivered) ctx.delivered->store(++delivered, std::memory_order_relaxed);
         // "parse" into Tick (no allocation)
         Tick tk;
         tk.seq = m.seq;
@@ -28,5 +81,84 @@ void consumer_thread_func(SPSCQueue<RawMsg> &q, std::atomic<bool> &run_flag,
         tk.price = m.price;
         // (In a real pipeline, push Tick downstream)
         (void)tk;
+        const bool traced = ctx.tracer && ctx.tracer->sampled(m.seq);
+        if (traced) ctx.tracer->stamp(m.seq, TraceStage::Decoded, now_ns());
+
+        uint64_t latency = t_recv - m.t_sent_ns;
+        if (ctx.histogram) ctx.histogram->record(latency);
+        if (ctx.sketch) ctx.sketch->record(latency);
+        if (ctx.intervals) ctx.intervals->record(latency);
+        if (ctx.backfill_stalls && from_stalls) {
+            // only the message that waited carries the stall, so each is back-filled once,
+            // one value per send gap the producer had in effect
+            const StallRing::Stall s = from_stalls->find(m.seq);
+            if (s.gap_ns && s.stall_ns >= s.gap_ns) [[unlikely]] {
+                if (ctx.histogram) ctx.histogram->record_backfill(latency, s.stall_ns, s.gap_ns);
+                if (ctx.sketch) ctx.sketch->record_backfill(latency, s.stall_ns, s.gap_ns);
+                if (ctx.intervals) ctx.intervals->record_backfill(latency, s.stall_ns, s.gap_ns);
+            }
+        }
+        if (ctx.metrics) ctx.metrics->record_latency(latency);
+        if (ctx.symbols) ctx.symbols->record(m.symbol_id, latency);
+        if (ctx.flight) {
+            FlightRecorder &fr = *ctx.flight_recorder;
+            if (ctx.flight_gaps && last_seq && m.seq > last_seq + 1) [[unlikely]] {
+                ctx.flight->record(FlightEvent::Gap, m.seq, flight_arg(m.seq - last_seq - 1), t_recv);
+                if (fr.gap_trigger()) fr.trigger(FlightTrigger::Gap, m.seq, m.seq - last_seq - 1, t_recv);
+            }
+            if (fr.latency_trigger() && latency > fr.latency_trigger()) [[unlikely]] {
+                ctx.flight->record(FlightEvent::Slow, m.seq, flight_arg(latency), t_recv);
+                fr.trigger(FlightTrigger::Latency, m.seq, latency, t_recv);
+            }
+            if (m.seq > last_seq) last_seq = m.seq;
+        }
+        if (ctx.outliers && latency > ctx.outliers->threshold()) [[unlikely]] {
+            Outlier o;
+            o.latency_ns = latency;
+            o.seq = m.seq;
+            o.t_recv_ns = t_recv;
+            o.queue_depth = from->approx_size();
+            o.producer_stall_ns = from_stalls ? from_stalls->lookup(m.seq) : 0;
+            o.symbol_id = m.symbol_id;
+            o.cpu = current_cpu();
+            ctx.outliers->offer(o);
+        }
+        if (ctx.sampler) {
+            ctx.sampler->offer(latency, t_recv);
+        } else if (ctx.latencies_ns && ctx.latencies_ns->size() < ctx.max_collect) {
+            ctx.latencies_ns->push_back(latency);
+        }
+        if (traced) ctx.tracer->finish(m.seq, now_ns());
+    };
+
+    RawMsg m;
+    while (run_flag.load(std::memory_order_relaxed)) {
+        if (!pop(m)) {
+            if (batch && ctx.flight) ctx.flight->record(FlightEvent::Batch, 0, batch, now_ns());
+            batch = 0;
+            if (ctx.reorder && ctx.reorder->held_now()) {
+                t_recv = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+                ctx.reorder->poll(t_recv, deliver);
+            }
+            if (ctx.intervals) ctx.intervals->poll();
+            publish_reorder(ctx);
+            std::this_thread::yield();
+            continue;
+        }
+        t_recv = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        if (ctx.tracer && ctx.tracer->sampled(m.seq)) ctx.tracer->stamp(m.seq, TraceStage::Dequeue, t_recv);
+        ++batch;
+        if (ctx.flight) ctx.flight->record(FlightEvent::Pop, m.seq, batch, t_recv);
+        if (ctx.reorder) {
+            ctx.reorder->push(m, t_recv, deliver);
+            if ((m.seq & 1023) == 0) publish_reorder(ctx);
+        } else {
+            deliver(m);
+        }
+    }
+    if (ctx.reorder) {
+        t_recv = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        ctx.reorder->flush(t_recv, deliver);
+        publish_reorder(ctx);
     }
 }
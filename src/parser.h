@@ -5,6 +5,17 @@
 #include <vector>
 #include <atomic>
 #include "spsc_ringbuffer.h"
+#include "reorder_window.h"
+#include "hdr_histogram.h"
+#include "ddsketch.h"
+#include "interval_recorder.h"
+#include "stage_trace.h"
+#include "shm_metrics.h"
+#include "outlier_tracker.h"
+#include "perf_counters.h"
+#include "latency_sampler.h"
+#include "symbol_stats.h"
+#include "flight_recorder.h"
 
 /**
  * @file parser.h
@@ -102,3 +113,76 @@ void consumer_thread_func(SPSCQueue<RawMsg> &q,
                          std::atomic<bool> &run_flag, 
                          std::vector<uint64_t> &latencies_ns, 
                          size_t max_collect);
+
+/**
+ * @struct ConsumerContext
+ * @brief Optional collaborators of the consumer thread
+ *
+ * Every member is optional; a null pointer disables the corresponding
+ * feature. All referenced objects are owned by the caller, used only by the
+ * consumer thread while it runs, and may be inspected after it is joined
+ * (delivered and metrics are the exception: they may be read with relaxed
+ * loads at any time, also from other processes).
+ */
+struct ConsumerContext {
+    LatencyHistogram *histogram = nullptr;          ///< Records every latency (fixed memory)
+    DDSketch *sketch = nullptr;                     ///< Records every latency (relative error)
+    std::vector<uint64_t> *latencies_ns = nullptr;  ///< Raw latency samples (first max_collect)
+    size_t max_collect = 0;                         ///< Sample cap for latencies_ns
+    LatencySampler *sampler = nullptr;              ///< Bounded raw samples (instead of latencies_ns)
+    ReorderWindow *reorder = nullptr;               ///< Restores seq order before decoding
+    IntervalRecorder *intervals = nullptr;          ///< Per-interval latency histograms
+    bool backfill_stalls = false;                   ///< Back-fill the sends hidden by producer stalls
+    std::atomic<uint64_t> *delivered = nullptr;     ///< Messages delivered so far (monitoring)
+    StageTracer *tracer = nullptr;                  ///< Per-stage timing of sampled messages
+    MetricsRegion *metrics = nullptr;               ///< Live metrics: latency histogram, reorder drops
+    OutlierTracker *outliers = nullptr;             ///< Worst-K latencies with context
+    const StallRing *stalls = nullptr;              ///< Stalls of the producer behind q (outliers, back-fill)
+    PerfCounters *perf = nullptr;                   ///< Opened for the consumer thread on start
+    SymbolStats *symbols = nullptr;                 ///< Per-symbol counts and latency histograms
+    FlightRing *flight = nullptr;                   ///< Flight recorder ring: pops, batches, gaps, slow messages
+    FlightRecorder *flight_recorder = nullptr;      ///< Trigger rules and dumps for flight
+    bool flight_gaps = false;                       ///< Sequence numbers are contiguous; record gaps
+    std::vector<SPSCQueue<RawMsg> *> inputs;        ///< Further queues polled with q (one per extra producer)
+    std::vector<const StallRing *> input_stalls;    ///< Stalls of the producers behind inputs (empty or parallel to inputs)
+};
+
+/**
+ * @brief Consumer thread function with optional pipeline stages
+ *
+ * Same processing as the four-argument overload. Every latency goes into
+ * whichever of ctx.histogram and ctx.sketch are set, at constant cost; raw
+ * samples are additionally kept in ctx.latencies_ns up to ctx.max_collect
+ * (or offered to ctx.sampler, which can sample the whole run instead),
+ * and ctx.intervals receives every latency for the per-interval time series
+ * (its flip requests are also serviced while idle). When
+ * ctx.backfill_stalls is set, a message whose producer waited for queue
+ * space (as recorded in the stall ring of its queue) also has the sends that
+ * wait hid, one per send gap the producer had in effect (recorded with the
+ * stall), back-filled into the histogram, sketch and interval recorders, once per stall and at bounded cost (coordinated-omission correction, see
+ * LatencyHistogram::record_backfill()); raw samples stay uncorrected. When
+ * ctx.tracer is set, sampled
+ * messages are stamped at Dequeue, Decoded and Sunk (see StageTracer). When
+ * ctx.outliers is set, messages slower than the tracker's current threshold
+ * are offered with their queue depth, producer stall (from the stall ring of
+ * the queue they came from) and CPU. ctx.perf, if
+ * set, is opened for this thread before the first message. With ctx.flight,
+ * every pop, batch end, gap and slow message is appended to the ring, and
+ * slow messages and gaps fire ctx.flight_recorder's triggers.
+ *
+ * When ctx.reorder is set, messages pass through the reorder window before
+ * decoding, so ticks are produced in sequence order; latency is then
+ * measured at delivery and includes the time a message was held. Held
+ * messages are flushed in order when the run stops.
+ *
+ * When ctx.inputs is non-empty, @p q and every queue in it are popped
+ * round-robin, one message at a time, so no producer's queue starves the
+ * others.
+ *
+ * @param q Reference to the SPSC queue for message consumption
+ * @param run_flag Atomic flag to control thread execution
+ * @param ctx Optional collaborators (see ConsumerContext)
+ */
+void consumer_thread_func(SPSCQueue<RawMsg> &q,
+                          std::atomic<bool> &run_flag,
+                          ConsumerContext &ctx);
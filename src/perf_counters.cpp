@@ -0,0 +1,138 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define FFP_HAVE_PERF 1
+#endif
+
+namespace {
+
+const char *const kEventNames[kPerfEvents] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses",
+    "dtlb-misses", "page-faults", "ctx-switches", "migrations",
+};
+
+#ifdef FFP_HAVE_PERF
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_miss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+const EventSpec kEventSpecs[kPerfEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+};
+
+int open_event(const EventSpec &spec, bool exclude_kernel) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = exclude_kernel;
+    attr.exclude_hv = 1;
+    // pid 0, cpu -1: the calling thread, on whichever CPU it runs
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+#endif
+
+}  // namespace
+
+PerfReading PerfReading::operator-(const PerfReading &earlier) const noexcept {
+    PerfReading d = *this;
+    for (size_t i = 0; i < kPerfEvents; ++i) {
+        d.value[i] = value[i] >= earlier.value[i] ? value[i] - earlier.value[i] : 0;
+    }
+    return d;
+}
+
+PerfReading &PerfReading::operator+=(const PerfReading &other) noexcept {
+    for (size_t i = 0; i < kPerfEvents; ++i) {
+        value[i] += other.value[i];
+        valid[i] = valid[i] && other.valid[i];
+    }
+    return *this;
+}
+
+PerfCounters::PerfCounters() noexcept {
+    fd_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef FFP_HAVE_PERF
+    for (int fd : fd_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+const char *PerfCounters::event_name(size_t i) noexcept {
+    return i < kPerfEvents ? kEventNames[i] : "?";
+}
+
+#ifdef FFP_HAVE_PERF
+
+size_t PerfCounters::open() noexcept {
+    size_t n = 0;
+    for (size_t i = 0; i < kPerfEvents; ++i) {
+        // Kernel-side counts (faults, switches) need perf_event_paranoid < 2;
+        // fall back to user space only
+        int fd = open_event(kEventSpecs[i], false);
+        if (fd < 0 && (errno == EACCES || errno == EPERM)) fd = open_event(kEventSpecs[i], true);
+        if (fd < 0) {
+            if (error_.empty()) error_ = std::string(kEventNames[i]) + ": " + std::strerror(errno);
+            continue;
+        }
+        fd_[i] = fd;
+        ++n;
+    }
+    opened_.store(true, std::memory_order_release);
+    return n;
+}
+
+PerfReading PerfCounters::read() const noexcept {
+    PerfReading r;
+    if (!opened()) return r;
+    for (size_t i = 0; i < kPerfEvents; ++i) {
+        if (fd_[i] < 0) continue;
+        uint64_t buf[3] = {0, 0, 0};  // value, time enabled, time running
+        if (::read(fd_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || buf[2] == 0) continue;
+        // Scale up when the PMU multiplexed this event with others
+        r.value[i] = buf[2] < buf[1] ? static_cast<uint64_t>(static_cast<double>(buf[0]) * buf[1] / buf[2])
+                                     : buf[0];
+        r.valid[i] = true;
+    }
+    return r;
+}
+
+#else
+
+size_t PerfCounters::open() noexcept {
+    error_ = "perf_event_open is only available on Linux";
+    opened_.store(true, std::memory_order_release);
+    return 0;
+}
+
+PerfReading PerfCounters::read() const noexcept {
+    return PerfReading{};
+}
+
+#endif
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file perf_counters.h
+ * @brief Per-thread hardware performance counters (Linux perf_event_open)
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * An external `perf stat` sees the whole process. Opening the counters from
+ * inside each pipeline thread separates producer from consumer, and reading
+ * them from the monitor at the end of warm-up separates warm-up from steady
+ * state, at no cost to the hot loops: the kernel counts, nobody polls.
+ *
+ * Counters are frequently unavailable in VMs and containers (no virtual PMU,
+ * perf_event_paranoid, seccomp). Each event is opened on its own and any
+ * that fail are reported as unavailable; the software events (page faults,
+ * context switches, migrations) usually survive where the hardware ones do
+ * not.
+ */
+
+/**
+ * @enum PerfEvent
+ * @brief Events counted for each thread
+ */
+enum class PerfEvent : size_t {
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    BranchMisses,
+    DtlbMisses,
+    PageFaults,
+    ContextSwitches,
+    Migrations,
+    Count
+};
+
+/// @brief Number of counted events
+inline constexpr size_t kPerfEvents = static_cast<size_t>(PerfEvent::Count);
+
+/**
+ * @struct PerfReading
+ * @brief Counter values at one instant, scaled for multiplexing
+ */
+struct PerfReading {
+    std::array<uint64_t, kPerfEvents> value{};  ///< Event counts
+    std::array<bool, kPerfEvents> valid{};      ///< Counter open and has run
+
+    /// @brief Counts accumulated since @p earlier (validity taken from this reading)
+    PerfReading operator-(const PerfReading &earlier) const noexcept;
+
+    /// @brief Adds the counts of @p other; a sum is valid only if both parts are
+    PerfReading &operator+=(const PerfReading &other) noexcept;
+};
+
+/**
+ * @class PerfCounters
+ * @brief The counters of one thread
+ *
+ * open() must be called from the thread to be measured; counting starts
+ * immediately. read() may then be called from any thread, including after
+ * the measured thread has exited (its counts are frozen at exit).
+ */
+class PerfCounters {
+public:
+    PerfCounters() noexcept;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Opens and starts every event for the calling thread
+     *
+     * @return Number of events that could be opened (0 on non-Linux systems)
+     */
+    size_t open() noexcept;
+
+    /// @brief True once open() has completed (any thread)
+    bool opened() const noexcept {
+        return opened_.load(std::memory_order_acquire);
+    }
+
+    /// @brief Current counts; all invalid before open() completes
+    PerfReading read() const noexcept;
+
+    /// @brief Why the first unavailable event failed to open (empty if none)
+    const std::string &error() const noexcept {
+        return error_;
+    }
+
+    /// @brief Short event name, e.g. "llc-misses"
+    static const char *event_name(size_t i) noexcept;
+
+private:
+    std::array<int, kPerfEvents> fd_;
+    std::string error_;
+    std::atomic<bool> opened_{false};
+};
@@ -0,0 +1,156 @@
+#include "prometheus_exporter.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define FFP_HAVE_SOCKETS 1
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace {
+
+// Histogram boundaries: 2^8 - 1 .. 2^34 - 1 ns (region buckets start at 2^k)
+constexpr unsigned kFirstBoundaryLog2 = 8;
+constexpr unsigned kLastBoundaryLog2 = 34;
+
+uint64_t load(const std::atomic<uint64_t> &a) noexcept {
+    return a.load(std::memory_order_relaxed);
+}
+
+void metric(std::ostringstream &os, const char *name, const char *type, const char *help, double value) {
+    os << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n"
+       << name << " " << value << "\n";
+}
+
+}  // namespace
+
+std::string render_prometheus(const MetricsRegion &r) {
+    std::ostringstream os;
+    os.precision(12);
+    metric(os, "ffp_messages_produced_total", "counter", "Messages generated by the producer.", load(r.produced));
+    metric(os, "ffp_messages_consumed_total", "counter", "Messages delivered by the consumer.", load(r.consumed));
+    metric(os, "ffp_arbiter_duplicates_total", "counter", "Redundant A/B copies dropped by the arbiter.",
+           load(r.arb_duplicates));
+    metric(os, "ffp_arbiter_stale_total", "counter", "Copies older than the arbitration window (dropped).",
+           load(r.arb_stale));
+    metric(os, "ffp_arbiter_lost_total", "counter", "Sequences lost on both feed lines.", load(r.arb_lost));
+    metric(os, "ffp_reorder_late_total", "counter", "Messages behind the reorder delivery point (dropped).",
+           load(r.reorder_late));
+    metric(os, "ffp_reorder_skipped_total", "counter", "Sequence gaps the reorder window gave up on.",
+           load(r.reorder_skipped));
+    metric(os, "ffp_queue_depth", "gauge", "Main queue depth at the last reporting interval.", load(r.queue_depth));
+    metric(os, "ffp_queue_capacity", "gauge", "Main queue capacity.", load(r.queue_capacity));
+    metric(os, "ffp_target_rate", "gauge", "Configured messages per second.", load(r.target_rate));
+    metric(os, "ffp_running", "gauge", "1 while the benchmark runs.", r.running.load(std::memory_order_relaxed));
+    metric(os, "ffp_latency_max_seconds", "gauge", "Largest end-to-end latency so far.",
+           load(r.latency_max_ns) / 1e9);
+
+    os << "# HELP ffp_latency_seconds End-to-end message latency.\n# TYPE ffp_latency_seconds histogram\n";
+    uint64_t cumulative = 0;
+    size_t i = 0;
+    for (unsigned k = kFirstBoundaryLog2; k <= kLastBoundaryLog2; ++k) {
+        const uint64_t limit = uint64_t{1} << k;
+        for (; i < kMetricsLatencyBuckets && MetricsRegion::bucket_lower(i) < limit; ++i) {
+            cumulative += load(r.latency[i]);
+        }
+        // Latencies are whole nanoseconds: everything below 2^k is at most 2^k - 1
+        os << "ffp_latency_seconds_bucket{le=\"" << (limit - 1) / 1e9 << "\"} " << cumulative << "\n";
+    }
+    for (; i < kMetricsLatencyBuckets; ++i) cumulative += load(r.latency[i]);
+    os << "ffp_latency_seconds_bucket{le=\"+Inf\"} " << cumulative << "\n";
+    os << "ffp_latency_seconds_sum " << load(r.latency_sum_ns) / 1e9 << "\n";
+    os << "ffp_latency_seconds_count " << cumulative << "\n";
+    return os.str();
+}
+
+#ifdef FFP_HAVE_SOCKETS
+
+PrometheusExporter::PrometheusExporter(const MetricsRegion &region, uint16_t port) : region_(region) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) throw std::runtime_error(std::string("cannot create socket: ") + std::strerror(errno));
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    socklen_t len = sizeof(addr);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 8) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+        std::string err = std::strerror(errno);
+        close(listen_fd_);
+        throw std::runtime_error("cannot listen on 127.0.0.1:" + std::to_string(port) + ": " + err);
+    }
+    port_ = ntohs(addr.sin_port);
+    thread_ = std::thread([this] { serve(); });
+}
+
+PrometheusExporter::~PrometheusExporter() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) thread_.join();
+    if (listen_fd_ >= 0) close(listen_fd_);
+}
+
+void PrometheusExporter::serve() {
+    pollfd p{listen_fd_, POLLIN, 0};
+    while (!stop_.load(std::memory_order_relaxed)) {
+        // Wake up regularly to notice stop_
+        if (poll(&p, 1, 200) <= 0) continue;
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue;
+        handle(fd);
+        close(fd);
+    }
+}
+
+void PrometheusExporter::handle(int fd) {
+    timeval tv{1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    // Only the request line matters; read until the end of the headers
+    std::string req;
+    char buf[1024];
+    while (req.size() < 8192 && req.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) break;
+        req.append(buf, static_cast<size_t>(n));
+    }
+    const bool metrics = req.rfind("GET /metrics ", 0) == 0 || req.rfind("GET /metrics?", 0) == 0;
+    std::string body = metrics ? render_prometheus(region_) : "not found; try /metrics\n";
+    std::string resp = std::string(metrics ? "HTTP/1.0 200 OK" : "HTTP/1.0 404 Not Found") +
+                       "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+                       std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    for (size_t off = 0; off < resp.size();) {
+        ssize_t n = send(fd, resp.data() + off, resp.size() - off, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        off += static_cast<size_t>(n);
+    }
+    if (metrics) scrapes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+#else
+
+PrometheusExporter::PrometheusExporter(const MetricsRegion &region, uint16_t) : region_(region) {
+    throw std::runtime_error("the Prometheus endpoint is not supported on this platform");
+}
+
+PrometheusExporter::~PrometheusExporter() = default;
+
+void PrometheusExporter::serve() {}
+
+void PrometheusExporter::handle(int) {}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "shm_metrics.h"
+
+/**
+ * @file prometheus_exporter.h
+ * @brief Prometheus text-format endpoint over the live metrics region
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Serves GET /metrics on a loopback port from its own thread. Every value is
+ * read from a MetricsRegion, which the pipeline threads already publish with
+ * single-writer relaxed atomic stores, so a scrape never takes a lock or
+ * touches a hot thread's private state.
+ */
+
+/**
+ * @brief Renders @p r in the Prometheus text exposition format (0.0.4)
+ *
+ * Counters for produced and consumed messages, arbiter drops and reorder
+ * drops and gaps; gauges for queue depth, capacity, target rate and maximum
+ * latency; and a latency histogram with boundaries at 2^k - 1 ns (255 ns to
+ * 17 s). Latencies are whole nanoseconds and the region's own buckets start
+ * at powers of two, so every le bucket holds exactly the latencies at or
+ * below its boundary.
+ */
+std::string render_prometheus(const MetricsRegion &r);
+
+/**
+ * @class PrometheusExporter
+ * @brief Minimal HTTP/1.0 listener answering Prometheus scrapes
+ *
+ * Binds 127.0.0.1 only. Requests are handled one at a time with short
+ * timeouts; anything other than GET /metrics gets a 404.
+ *
+ * @note Available on POSIX systems; the constructor throws elsewhere.
+ */
+class PrometheusExporter {
+public:
+    /**
+     * @brief Starts serving @p region on 127.0.0.1:@p port
+     *
+     * @param region Metrics to expose; must outlive the exporter
+     * @param port TCP port (0 picks a free one, see port())
+     * @throws std::runtime_error if the socket cannot be bound
+     */
+    PrometheusExporter(const MetricsRegion &region, uint16_t port);
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter &) = delete;
+    PrometheusExporter &operator=(const PrometheusExporter &) = delete;
+
+    /// @brief Bound port
+    uint16_t port() const noexcept {
+        return port_;
+    }
+
+    /// @brief Scrapes answered so far
+    uint64_t scrapes() const noexcept {
+        return scrapes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void serve();
+    void handle(int fd);
+
+    const MetricsRegion &region_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> scrapes_{0};
+    std::thread thread_;
+};
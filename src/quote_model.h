@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file quote_model.h
+ * @brief Per-symbol random-walk quotes for the synthetic feed
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Independent uniform prices make every tick of a symbol jump across the
+ * whole range, which no delta encoder, book or conflation stage ever sees in
+ * production. QuoteModel keeps a best bid and ask per instrument on the
+ * instrument's tick grid instead:
+ *
+ *   - each update moves both sides one tick up or down with probability
+ *     kMoveProb, and a few ticks with probability kJumpProb;
+ *   - the spread widens or narrows by a tick with probability kSpreadProb,
+ *     staying within 1..kMaxSpread ticks;
+ *   - the update quotes the bid or the ask with equal probability;
+ *   - sizes are whole lots, Pareto-distributed with tail index kSizeAlpha
+ *     (most quotes are a lot or two, a few are hundreds).
+ *
+ * Starting prices, tick sizes (0.01, 0.05 or 0.25) and lot sizes are fixed
+ * per symbol id, so the same id always describes the same instrument.
+ */
+
+/**
+ * @class QuoteModel
+ * @brief Best bid/ask state of every symbol, advanced one quote at a time
+ *
+ * @note Not thread-safe; one model belongs to the producer thread.
+ */
+class QuoteModel {
+public:
+    static constexpr double kMoveProb = 0.25;     ///< One-tick mid move per update
+    static constexpr double kJumpProb = 0.01;     ///< 2-5 tick mid move per update
+    static constexpr double kSpreadProb = 0.10;   ///< One-tick spread change per update
+    static constexpr uint32_t kMaxSpread = 8;     ///< Widest spread, in ticks
+    static constexpr double kSizeAlpha = 1.5;     ///< Pareto tail index of sizes
+    static constexpr uint32_t kMaxLots = 10'000;  ///< Size cap, in lots
+
+    /// @brief One quote
+    struct Quote {
+        double price;   ///< Bid or ask price, a multiple of the symbol's tick
+        uint32_t size;  ///< Multiple of the symbol's lot size
+    };
+
+    /**
+     * @param universe Highest symbol id (ids first..universe)
+     * @param seed Seed of the walk
+     * @param first Lowest symbol id
+     * @throws std::invalid_argument if there is no symbol id in first..universe
+     */
+    explicit QuoteModel(uint32_t universe, uint64_t seed = 0xA0761D6478BD642FULL, uint32_t first = 1)
+        : first_(first), rng_(seed ? seed : 1) {
+        if (first == 0 || universe < first) throw std::invalid_argument("quote model needs at least one symbol");
+        books_.resize(static_cast<size_t>(universe - first) + 1);
+        for (uint32_t id = first; id <= universe; ++id) {
+            Book &b = books_[id - first];
+            uint64_t h = mix(id);
+            // 70% cent ticks in 100-lots (equities), 20% nickel ticks, 10% quarter ticks in single lots (futures)
+            const uint32_t kind = static_cast<uint32_t>(h % 10);
+            b.tick = kind < 7 ? 0.01 : kind < 9 ? 0.05 : 0.25;
+            b.lot = kind < 9 ? 100 : 1;
+            // Starting mid log-uniform over 5..500
+            const double u = static_cast<double>((h = mix(h)) >> 11) * (1.0 / 9007199254740992.0);
+            const double mid = 5.0 * std::pow(100.0, u);
+            b.spread = 1 + static_cast<uint32_t>(mix(h) % 3);
+            b.bid = std::max<int64_t>(1, std::llround(mid / b.tick) - b.spread / 2);
+        }
+    }
+
+    /**
+     * @brief Advances @p symbol_id by one update and returns the side it quoted
+     *
+     * @p symbol_id must be in first..universe.
+     */
+    Quote next(uint32_t symbol_id) noexcept {
+        Book &b = books_[symbol_id - first_];
+        const uint64_t r = draw();
+        const double u = (r >> 40) * (1.0 / 16777216.0);  // 24 bits
+        const bool up = r & 1, widen = r & 2, ask = r & 4;
+        if (u < kJumpProb) {
+            b.bid += (up ? 1 : -1) * static_cast<int64_t>(2 + (r >> 3) % 4);
+        } else if (u < kJumpProb + kMoveProb) {
+            b.bid += up ? 1 : -1;
+        } else if (u < kJumpProb + kMoveProb + kSpreadProb) {
+            // Move the side that is not quoted, so the quoted side keeps its level
+            if (widen && b.spread < kMaxSpread) {
+                ++b.spread;
+                if (ask) --b.bid;
+            } else if (!widen && b.spread > 1) {
+                --b.spread;
+                if (ask) ++b.bid;
+            }
+        }
+        if (b.bid < 1) b.bid = 1;  // the bid never falls below one tick
+        const int64_t level = ask ? b.bid + b.spread : b.bid;
+
+        // Pareto: lots = floor(U^(-1/alpha)) >= 1
+        const double v = (static_cast<double>(draw() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+        const double lots = std::min(std::floor(std::pow(v, -1.0 / kSizeAlpha)), static_cast<double>(kMaxLots));
+        return {static_cast<double>(level) * b.tick, static_cast<uint32_t>(lots) * b.lot};
+    }
+
+    /// @brief Current best bid of @p symbol_id
+    double bid(uint32_t symbol_id) const noexcept {
+        const Book &b = books_[symbol_id - first_];
+        return b.bid * b.tick;
+    }
+
+    /// @brief Current best ask of @p symbol_id
+    double ask(uint32_t symbol_id) const noexcept {
+        const Book &b = books_[symbol_id - first_];
+        return (b.bid + b.spread) * b.tick;
+    }
+
+    /// @brief Tick size of @p symbol_id
+    double tick(uint32_t symbol_id) const noexcept { return books_[symbol_id - first_].tick; }
+
+    /// @brief Bytes held by the per-symbol state
+    size_t memory_bytes() const noexcept { return books_.size() * sizeof(Book); }
+
+private:
+    struct Book {
+        int64_t bid = 1;      // Best bid, in ticks
+        double tick = 0.01;   // Price increment
+        uint32_t spread = 1;  // Ask minus bid, in ticks
+        uint32_t lot = 1;     // Size increment
+    };
+
+    // splitmix64 finalizer: fixed per-symbol parameters
+    static uint64_t mix(uint64_t x) noexcept {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // xorshift64*
+    uint64_t draw() noexcept {
+        rng_ ^= rng_ >> 12;
+        rng_ ^= rng_ << 25;
+        rng_ ^= rng_ >> 27;
+        return rng_ * 0x2545F4914F6CDD1DULL;
+    }
+
+    uint32_t first_;
+    std::vector<Book> books_;  // books_[id - first_]
+    uint64_t rng_;
+};
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "feed_generator.h"
+
+/**
+ * @file reorder_window.h
+ * @brief Fixed-size sequence reordering buffer for the consumer
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Restores sequence order for messages that arrive slightly out of order,
+ * for example after A/B arbitration fills a gap from the slower line or when
+ * several receive threads feed one consumer.
+ */
+
+/**
+ * @struct ReorderStats
+ * @brief Counters describing reordering activity
+ *
+ * Owned by the consumer thread; read only after that thread has been joined.
+ */
+struct ReorderStats {
+    uint64_t in_order = 0;       ///< Messages delivered immediately (no hold)
+    uint64_t held = 0;           ///< Messages held until their predecessors arrived
+    uint64_t late = 0;           ///< Messages behind the delivery point (dropped)
+    uint64_t skipped = 0;        ///< Sequences given up on after a timeout or overflow
+    uint64_t timeouts = 0;       ///< Times a gap was abandoned because of the timeout
+    uint64_t hold_ns_total = 0;  ///< Sum of hold times of held messages
+    uint64_t hold_ns_max = 0;    ///< Longest hold time observed
+
+    /// @brief Average hold time of held messages in nanoseconds
+    double hold_ns_avg() const noexcept {
+        return held ? static_cast<double>(hold_ns_total) / held : 0.0;
+    }
+};
+
+/**
+ * @class ReorderWindow
+ * @brief Ring-indexed reorder buffer that releases messages in sequence order
+ *
+ * Messages are stored in slot seq & (window - 1). A message with the next
+ * expected sequence is delivered at once, followed by any consecutive held
+ * messages behind it. Early arrivals wait in their slot until the gap ahead
+ * of them fills, until the oldest of them has waited longer than the
+ * timeout, or until a sequence arrives that would not fit in the window; in
+ * the last two cases the missing sequences are skipped and counted.
+ *
+ * All storage is allocated in the constructor. push(), poll() and flush()
+ * never allocate; delivered messages are handed to a caller-supplied sink.
+ * Held sequence numbers are also queued in arrival order, so the oldest
+ * held message is found in amortized constant time when the timeout has to
+ * restart after a partial drain, whatever the window size.
+ *
+ * @note Not thread-safe. One window belongs to one consumer thread.
+ *
+ * Example usage:
+ * @code
+ * ReorderWindow rw(1024, 100'000);  // 1024 slots, 100us timeout
+ * rw.push(msg, now_ns, [&](const RawMsg &m) { handle(m); });
+ * rw.poll(now_ns, [&](const RawMsg &m) { handle(m); });  // when idle
+ * @endcode
+ */
+class ReorderWindow {
+public:
+    /**
+     * @brief Constructs a reorder window
+     *
+     * @param window_pow2 Number of slots (power of two, at least 2)
+     * @param timeout_ns Longest time a message may wait for a gap to fill
+     *
+     * @throws std::invalid_argument if window_pow2 is not a power of two >= 2
+     */
+    ReorderWindow(size_t window_pow2, uint64_t timeout_ns)
+        : window_(window_pow2),
+          mask_(window_pow2 - 1),
+          timeout_ns_(timeout_ns),
+          msgs_(std::make_unique<RawMsg[]>(window_pow2)),
+          held_at_(std::make_unique<uint64_t[]>(window_pow2)),
+          arrivals_(std::make_unique<uint64_t[]>(2 * window_pow2)) {
+        if (window_pow2 < 2 || !std::has_single_bit(window_pow2)) {
+            throw std::invalid_argument("reorder window must be a power of two >= 2");
+        }
+        for (size_t i = 0; i < window_; ++i) msgs_[i].seq = 0;
+    }
+
+    /**
+     * @brief Accepts one message and delivers everything that is now in order
+     *
+     * @param m Received message
+     * @param now_ns Current time in nanoseconds (steady clock)
+     * @param sink Callable invoked as sink(const RawMsg&) for each delivery
+     */
+    template <typename Sink>
+    void push(const RawMsg &m, uint64_t now_ns, Sink &&sink) {
+        if (next_ == 0) next_ = m.seq;
+        if (m.seq == next_) [[likely]] {
+            ++stats_.in_order;
+            ++next_;
+            sink(m);
+            if (held_count_) {
+                drain_and_rearm(now_ns, sink);
+                poll(now_ns, sink);
+            }
+            return;
+        }
+        if (m.seq < next_) {
+            ++stats_.late;
+            return;
+        }
+        if (m.seq - next_ >= window_) make_room(m.seq, now_ns, sink);
+        if (m.seq == next_) {
+            ++stats_.in_order;
+            ++next_;
+            sink(m);
+            drain_and_rearm(now_ns, sink);
+            poll(now_ns, sink);
+            return;
+        }
+        size_t slot = m.seq & mask_;
+        if (msgs_[slot].seq == m.seq) {
+            ++stats_.late;  // duplicate of a held message
+            return;
+        }
+        msgs_[slot] = m;
+        held_at_[slot] = now_ns;
+        if (held_count_++ == 0) {
+            stall_start_ns_ = now_ns;
+            arrivals_head_ = arrivals_tail_;
+        } else {
+            drop_delivered_arrivals();
+        }
+        arrivals_[arrivals_tail_++ & (2 * window_ - 1)] = m.seq;
+        poll(now_ns, sink);
+    }
+
+    /**
+     * @brief Abandons the blocking gap if a held message exceeded the timeout
+     *
+     * Call periodically while no messages arrive so held messages are still
+     * released on time.
+     *
+     * @param now_ns Current time in nanoseconds (steady clock)
+     * @param sink Callable invoked as sink(const RawMsg&) for each delivery
+     */
+    template <typename Sink>
+    void poll(uint64_t now_ns, Sink &&sink) {
+        while (held_count_ && now_ns - stall_start_ns_ >= timeout_ns_) {
+            ++stats_.timeouts;
+            skip_gap();
+            drain(now_ns, sink);
+            stall_start_ns_ = oldest_hold();
+        }
+    }
+
+    /**
+     * @brief Delivers every held message in order, skipping all gaps
+     *
+     * @param now_ns Current time in nanoseconds (steady clock)
+     * @param sink Callable invoked as sink(const RawMsg&) for each delivery
+     */
+    template <typename Sink>
+    void flush(uint64_t now_ns, Sink &&sink) {
+        while (held_count_) {
+            skip_gap();
+            drain(now_ns, sink);
+        }
+    }
+
+    /// @brief Reordering counters accumulated so far
+    const ReorderStats &stats() const noexcept {
+        return stats_;
+    }
+
+    /// @brief Number of messages currently held
+    size_t held_now() const noexcept {
+        return held_count_;
+    }
+
+private:
+    // Delivers held messages from next_ onward until the first empty slot.
+    template <typename Sink>
+    void drain(uint64_t now_ns, Sink &&sink) {
+        while (held_count_) {
+            size_t slot = next_ & mask_;
+            if (msgs_[slot].seq != next_) break;
+            uint64_t hold = now_ns - held_at_[slot];
+            stats_.hold_ns_total += hold;
+            if (hold > stats_.hold_ns_max) stats_.hold_ns_max = hold;
+            ++stats_.held;
+            --held_count_;
+            ++next_;
+            sink(msgs_[slot]);
+            msgs_[slot].seq = 0;
+        }
+    }
+
+    // drain(), then restarts the timeout from the oldest message still held:
+    // stall_start_ns_ may be the arrival of a message that was just delivered.
+    template <typename Sink>
+    void drain_and_rearm(uint64_t now_ns, Sink &&sink) {
+        const size_t before = held_count_;
+        drain(now_ns, sink);
+        if (held_count_ && held_count_ != before) stall_start_ns_ = oldest_hold();
+    }
+
+    // Advances next_ past the missing sequences up to the next held message.
+    void skip_gap() noexcept {
+        while (msgs_[next_ & mask_].seq != next_) {
+            ++stats_.skipped;
+            ++next_;
+        }
+    }
+
+    // Releases or skips until seq fits inside the window.
+    template <typename Sink>
+    void make_room(uint64_t seq, uint64_t now_ns, Sink &&sink) {
+        while (seq - next_ >= window_) {
+            if (held_count_ == 0) {
+                stats_.skipped += seq - next_ - (window_ - 1);
+                next_ = seq - (window_ - 1);
+                break;
+            }
+            skip_gap();
+            drain(now_ns, sink);
+        }
+        if (held_count_) stall_start_ns_ = oldest_hold();
+    }
+
+    // Pops arrival entries whose message is no longer held, up to the oldest
+    // one still held (needs held_count_ > 0). Every entry behind that one is
+    // a distinct sequence within a window of it, so 2 * window_ entries never
+    // overflow.
+    void drop_delivered_arrivals() noexcept {
+        const size_t amask = 2 * window_ - 1;
+        while (msgs_[arrivals_[arrivals_head_ & amask] & mask_].seq != arrivals_[arrivals_head_ & amask]) {
+            ++arrivals_head_;
+        }
+    }
+
+    // Arrival time of the longest-held message (UINT64_MAX if none is held).
+    uint64_t oldest_hold() noexcept {
+        if (held_count_ == 0) return UINT64_MAX;
+        drop_delivered_arrivals();
+        return held_at_[arrivals_[arrivals_head_ & (2 * window_ - 1)] & mask_];
+    }
+
+    size_t window_;                          ///< Slot count (power of 2)
+    size_t mask_;                            ///< window_ - 1
+    uint64_t timeout_ns_;                    ///< Maximum hold time before skipping a gap
+    std::unique_ptr<RawMsg[]> msgs_;         ///< Held messages (seq == 0 marks an empty slot)
+    std::unique_ptr<uint64_t[]> held_at_;    ///< Arrival time of each held message
+    std::unique_ptr<uint64_t[]> arrivals_;   ///< Held seqs in arrival order (2 * window_ ring, stale once delivered)
+    size_t arrivals_head_ = 0;               ///< Oldest queued arrival (free-running, masked on use)
+    size_t arrivals_tail_ = 0;               ///< Next arrival to queue
+    uint64_t next_ = 0;                      ///< Next sequence to deliver (0 = not started)
+    size_t held_count_ = 0;                  ///< Messages currently held
+    uint64_t stall_start_ns_ = 0;            ///< Arrival of the oldest held message
+    ReorderStats stats_;
+};
@@ -0,0 +1,269 @@
+#include "report.h"
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/utsname.h>
+#endif
+
+namespace {
+
+const std::pair<const char *, double> kSummaryQuantiles[] = {
+    {"p50", 0.50}, {"p90", 0.90}, {"p99", 0.99}, {"p999", 0.999}, {"p9999", 0.9999},
+};
+
+// First line of a file, or "unknown"
+std::string read_line(const char *path) {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line)) return "unknown";
+    return line;
+}
+
+std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            auto colon = line.find(':');
+            if (colon != std::string::npos) return line.substr(line.find_first_not_of(" \t", colon + 1));
+        }
+    }
+    return "unknown";
+}
+
+// Active mode of a sysfs multiple-choice file, e.g. "always [madvise] never"
+std::string selected_mode(const std::string &s) {
+    auto l = s.find('[');
+    auto r = s.find(']');
+    return (l != std::string::npos && r > l) ? s.substr(l + 1, r - l - 1) : s;
+}
+
+std::string json_escape(const std::string &s) {
+    std::string out;
+    out.reserve(s.size() + 2);
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::ostringstream u;
+                    u << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    out += u.str();
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string csv_escape(const std::string &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::vector<std::pair<std::string, std::string>> host_fields(const HostInfo &h) {
+    return {{"hostname", h.hostname}, {"kernel", h.kernel},     {"cpu_model", h.cpu_model},
+            {"cpus", std::to_string(h.cpus)}, {"governor", h.governor}, {"isolcpus", h.isolcpus},
+            {"thp", h.thp}};
+}
+
+double throughput(const RunReport &r) {
+    return r.duration_s > 0.0 ? r.consumed / r.duration_s : 0.0;
+}
+
+// Seconds from the run start to when the outlier was received
+double outlier_time(const RunReport &r, const Outlier &o) {
+    return o.t_recv_ns > r.t_start_ns ? (o.t_recv_ns - r.t_start_ns) / 1e9 : 0.0;
+}
+
+}  // namespace
+
+HostInfo collect_host_info() {
+    HostInfo h;
+    h.hostname = h.kernel = "unknown";
+#if defined(__unix__) || defined(__APPLE__)
+    utsname u{};
+    if (uname(&u) == 0) {
+        h.hostname = u.nodename;
+        h.kernel = u.release;
+    }
+#endif
+    h.cpu_model = cpu_model();
+    h.cpus = std::thread::hardware_concurrency();
+    h.governor = read_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    h.isolcpus = read_line("/sys/devices/system/cpu/isolated");
+    if (h.isolcpus.empty()) h.isolcpus = "none";
+    h.thp = selected_mode(read_line("/sys/kernel/mm/transparent_hugepage/enabled"));
+    return h;
+}
+
+void write_json(std::ostream &os, const RunReport &r) {
+    os << std::setprecision(10);
+    os << "{\n  \"version\": " << kReportVersion << ",\n";
+
+    auto object = [&](const char *name, const std::vector<std::pair<std::string, std::string>> &kv) {
+        os << "  \"" << name << "\": {";
+        for (size_t i = 0; i < kv.size(); ++i) {
+            os << (i ? ", " : "") << "\"" << json_escape(kv[i].first) << "\": \""
+               << json_escape(kv[i].second) << "\"";
+        }
+        os << "},\n";
+    };
+    object("config", r.config);
+    object("host", host_fields(r.host));
+
+    os << "  \"summary\": {\"duration_s\": " << r.duration_s << ", \"produced\": " << r.produced
+       << ", \"consumed\": " << r.consumed << ", \"throughput_msgs_per_s\": " << throughput(r);
+    if (r.histogram && r.histogram->count()) {
+        const LatencyHistogram &h = *r.histogram;
+        os << ", \"latency_ns\": {\"count\": " << h.count() << ", \"mean\": " << h.mean()
+           << ", \"min\": " << h.min();
+        for (const auto &[name, q] : kSummaryQuantiles) os << ", \"" << name << "\": " << h.value_at_quantile(q);
+        os << ", \"max\": " << h.max() << "}";
+    }
+    os << "},\n";
+
+    auto numbers = [&](const char *name, const std::vector<std::pair<std::string, double>> &kv) {
+        if (kv.empty()) return;
+        os << "  \"" << name << "\": {";
+        for (size_t i = 0; i < kv.size(); ++i) {
+            os << (i ? ", " : "") << "\"" << json_escape(kv[i].first) << "\": " << kv[i].second;
+        }
+        os << "},\n";
+    };
+    numbers("perf", r.perf);
+    numbers("pacing", r.pacing);
+
+    os << "  \"histogram\": {";
+    if (r.histogram) {
+        const LatencyHistogram &h = *r.histogram;
+        os << "\"significant_digits\": " << h.significant_digits() << ", \"buckets\": [";
+        bool first = true;
+        for (size_t i = 0; i < h.counts_size(); ++i) {
+            if (!h.count_at_index(i)) continue;
+            uint64_t lo = h.value_at_index(i);
+            os << (first ? "" : ", ") << "[" << lo << ", " << h.highest_equivalent(lo) << ", "
+               << h.count_at_index(i) << "]";
+            first = false;
+        }
+        os << "]";
+    }
+    os << "},\n";
+
+    os << "  \"series\": [";
+    if (r.series) {
+        for (size_t i = 0; i < r.series->size(); ++i) {
+            const IntervalSample &s = (*r.series)[i];
+            os << (i ? ",\n    " : "\n    ") << "{\"t_s\": " << s.t_s << ", \"length_s\": " << s.length_s
+               << ", \"produced\": " << s.produced << ", \"consumed\": " << s.consumed
+               << ", \"depth\": " << s.depth << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90
+               << ", \"p99\": " << s.p99 << ", \"p999\": " << s.p999 << ", \"max\": " << s.max << "}";
+        }
+        if (!r.series->empty()) os << "\n  ";
+    }
+    os << "],\n";
+
+    os << "  \"outliers\": [";
+    if (r.outliers) {
+        for (size_t i = 0; i < r.outliers->size(); ++i) {
+            const Outlier &o = (*r.outliers)[i];
+            os << (i ? ",\n    " : "\n    ") << "{\"latency_ns\": " << o.latency_ns << ", \"seq\": " << o.seq
+               << ", \"symbol_id\": " << o.symbol_id << ", \"t_s\": " << outlier_time(r, o)
+               << ", \"queue_depth\": " << o.queue_depth << ", \"producer_stall_ns\": "
+               << o.producer_stall_ns << ", \"cpu\": " << o.cpu << "}";
+        }
+        if (!r.outliers->empty()) os << "\n  ";
+    }
+    os << "]";
+
+    if (r.symbols_by_volume || r.symbols_by_p99) {
+        auto list = [&](const char *name, const std::vector<SymbolSummary> *v) {
+            os << "\"" << name << "\": [";
+            for (size_t i = 0; v && i < v->size(); ++i) {
+                const SymbolSummary &s = (*v)[i];
+                os << (i ? ",\n      " : "\n      ") << "{\"symbol_id\": " << s.symbol_id << ", \"count\": " << s.count
+                   << ", \"msgs_per_s\": " << (r.duration_s > 0.0 ? s.count / r.duration_s : 0.0)
+                   << ", \"p50\": " << s.p50 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << "}";
+            }
+            os << "]";
+        };
+        os << ",\n  \"symbols\": {";
+        list("by_volume", r.symbols_by_volume);
+        os << ",\n    ";
+        list("by_p99", r.symbols_by_p99);
+        os << "}";
+    }
+    os << "\n}\n";
+}
+
+void write_csv(std::ostream &os, const RunReport &r) {
+    os << std::setprecision(10);
+    os << "kind,key,value\n";
+    os << "version,report," << kReportVersion << "\n";
+    for (const auto &[k, v] : r.config) os << "config," << csv_escape(k) << "," << csv_escape(v) << "\n";
+    for (const auto &[k, v] : host_fields(r.host)) {
+        os << "host," << csv_escape(k) << "," << csv_escape(v) << "\n";
+    }
+    os << "summary,duration_s," << r.duration_s << "\n";
+    os << "summary,produced," << r.produced << "\n";
+    os << "summary,consumed," << r.consumed << "\n";
+    os << "summary,throughput_msgs_per_s," << throughput(r) << "\n";
+    for (const auto &[k, v] : r.perf) os << "perf," << csv_escape(k) << "," << v << "\n";
+    for (const auto &[k, v] : r.pacing) os << "pacing," << csv_escape(k) << "," << v << "\n";
+    if (r.histogram && r.histogram->count()) {
+        const LatencyHistogram &h = *r.histogram;
+        os << "summary,latency_count," << h.count() << "\n";
+        os << "summary,latency_mean_ns," << h.mean() << "\n";
+        for (const auto &[name, q] : kSummaryQuantiles) {
+            os << "summary,latency_" << name << "_ns," << h.value_at_quantile(q) << "\n";
+        }
+        os << "summary,latency_max_ns," << h.max() << "\n";
+
+        os << "kind,low_ns,high_ns,count\n";
+        for (size_t i = 0; i < h.counts_size(); ++i) {
+            if (!h.count_at_index(i)) continue;
+            uint64_t lo = h.value_at_index(i);
+            os << "histogram," << lo << "," << h.highest_equivalent(lo) << "," << h.count_at_index(i) << "\n";
+        }
+    }
+    if (r.series) {
+        os << "kind,t_s,length_s,produced,consumed,depth,p50,p90,p99,p999,max\n";
+        for (const IntervalSample &s : *r.series) {
+            os << "interval," << s.t_s << "," << s.length_s << "," << s.produced << "," << s.consumed
+               << "," << s.depth << "," << s.p50 << "," << s.p90 << "," << s.p99 << "," << s.p999 << ","
+               << s.max << "\n";
+        }
+    }
+    if (r.outliers) {
+        os << "kind,latency_ns,seq,symbol_id,t_s,queue_depth,producer_stall_ns,cpu\n";
+        for (const Outlier &o : *r.outliers) {
+            os << "outlier," << o.latency_ns << "," << o.seq << "," << o.symbol_id << "," << outlier_time(r, o)
+               << "," << o.queue_depth << "," << o.producer_stall_ns << "," << o.cpu << "\n";
+        }
+    }
+    auto symbols = [&](const char *kind, const std::vector<SymbolSummary> *v) {
+        if (!v) return;
+        os << "kind,symbol_id,count,msgs_per_s,p50,p99,max\n";
+        for (const SymbolSummary &s : *v) {
+            os << kind << "," << s.symbol_id << "," << s.count << ","
+               << (r.duration_s > 0.0 ? s.count / r.duration_s : 0.0) << "," << s.p50 << "," << s.p99 << ","
+               << s.max << "\n";
+        }
+    };
+    symbols("symbol_volume", r.symbols_by_volume);
+    symbols("symbol_p99", r.symbols_by_p99);
+}
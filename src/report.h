@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hdr_histogram.h"
+#include "interval_recorder.h"
+#include "outlier_tracker.h"
+#include "symbol_stats.h"
+
+/**
+ * @file report.h
+ * @brief Machine-readable benchmark reports (JSON and CSV)
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Writes everything a performance-tracking job needs to compare runs without
+ * scraping the console: run configuration, a fingerprint of the host,
+ * throughput, the full latency histogram and the per-interval time series.
+ * ffp-compare reads the JSON form.
+ */
+
+/// @brief Report format version; bump when fields are renamed or removed
+inline constexpr int kReportVersion = 1;
+
+/**
+ * @struct HostInfo
+ * @brief Machine settings that commonly explain run-to-run differences
+ *
+ * Fields that cannot be determined on this platform read "unknown".
+ */
+struct HostInfo {
+    std::string hostname;       ///< Node name
+    std::string kernel;         ///< Kernel release
+    std::string cpu_model;      ///< CPU model name
+    unsigned cpus = 0;          ///< Online hardware threads
+    std::string governor;       ///< cpufreq scaling governor of CPU 0
+    std::string isolcpus;       ///< Isolated CPU list
+    std::string thp;            ///< Transparent huge page mode
+};
+
+/**
+ * @brief Reads the host fingerprint from /proc and /sys (Linux)
+ */
+HostInfo collect_host_info();
+
+/**
+ * @struct RunReport
+ * @brief Everything written to a machine-readable report
+ *
+ * The histogram, series and outliers are borrowed and must outlive the report.
+ */
+struct RunReport {
+    std::vector<std::pair<std::string, std::string>> config;  ///< Option name and value
+    HostInfo host;                                             ///< Host fingerprint
+    double duration_s = 0.0;                                   ///< Measured run time
+    uint64_t produced = 0;                                     ///< Messages generated
+    uint64_t consumed = 0;                                     ///< Messages delivered
+    const LatencyHistogram *histogram = nullptr;               ///< Run-long latency histogram
+    const std::vector<IntervalSample> *series = nullptr;       ///< Per-interval time series
+    const std::vector<Outlier> *outliers = nullptr;            ///< Worst latencies, worst first
+    uint64_t t_start_ns = 0;                                   ///< Run start (steady clock), for outlier times
+    std::vector<std::pair<std::string, double>> perf;          ///< Hardware counters per message (optional)
+    std::vector<std::pair<std::string, double>> pacing;        ///< Achieved rate and send-time distributions
+    const std::vector<SymbolSummary> *symbols_by_volume = nullptr;  ///< Busiest symbols
+    const std::vector<SymbolSummary> *symbols_by_p99 = nullptr;     ///< Slowest symbols by p99
+};
+
+/**
+ * @brief Writes @p r as a JSON object
+ *
+ * Top-level keys: version, config, host, summary (throughput and latency
+ * percentiles), perf (counters per message, if collected), pacing (target
+ * and achieved rate, catch-up sends, inter-arrival and lateness percentiles),
+ * histogram (non-empty buckets as [low_ns, high_ns, count])
+ * series (one object per interval), outliers (worst latencies with
+ * context, t_s relative to the run start) and symbols (top symbols by volume
+ * and by p99, if collected).
+ */
+void write_json(std::ostream &os, const RunReport &r);
+
+/**
+ * @brief Writes @p r as CSV
+ *
+ * Every row starts with its kind: config, host and summary rows are
+ * kind,key,value, as are pacing rows and perf rows if counters were
+ * collected; histogram rows are kind,low_ns,high_ns,count; interval rows
+ * carry the IntervalSample
+ * fields, outlier rows the Outlier fields and symbol_volume / symbol_p99
+ * rows the SymbolSummary fields. A header row precedes each kind.
+ */
+void write_csv(std::ostream &os, const RunReport &r);
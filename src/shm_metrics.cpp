@@ -0,0 +1,127 @@
+#include "shm_metrics.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FFP_HAVE_SHM 1
+#endif
+
+namespace {
+
+[[noreturn]] void fail(const std::string &what, const std::string &name) {
+    throw std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+
+#ifdef FFP_HAVE_SHM
+
+// Why the existing object @p name must not be replaced, or an empty string
+// if it is a metrics region whose writer has finished or died
+std::string in_use_reason(const std::string &name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return {};  // removed in the meantime
+    struct stat st {};
+    void *p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(MetricsRegion)) {
+        p = mmap(nullptr, sizeof(MetricsRegion), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (p == MAP_FAILED) return "exists and is not a metrics region of this version";
+    const auto *r = static_cast<const MetricsRegion *>(p);
+    std::string reason;
+    const pid_t pid = static_cast<pid_t>(r->pid);
+    if (r->magic.load(std::memory_order_acquire) != kMetricsMagic) {
+        reason = "exists and is not a metrics region of this version";
+    } else if (r->running.load(std::memory_order_relaxed) && pid > 0 && (kill(pid, 0) == 0 || errno == EPERM)) {
+        reason = "is in use by running process " + std::to_string(pid);
+    }
+    munmap(p, sizeof(MetricsRegion));
+    return reason;
+}
+
+#endif
+
+}  // namespace
+
+#ifdef FFP_HAVE_SHM
+
+SharedMetrics::SharedMetrics(const std::string &name, Mode mode) : name_(name) {
+    const bool create = mode == Mode::Create;
+    int fd = create ? shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644)
+                    : shm_open(name.c_str(), O_RDONLY, 0);
+    if (create && fd < 0 && errno == EEXIST) {
+        // Replace only a region left behind by a finished or crashed run
+        const std::string reason = in_use_reason(name);
+        if (!reason.empty()) {
+            throw std::runtime_error("shared memory " + name + " " + reason + " (choose another --shm name)");
+        }
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) fail("cannot open shared memory", name);
+
+    if (create) {
+        if (ftruncate(fd, sizeof(MetricsRegion)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            fail("cannot size shared memory", name);
+        }
+    } else {
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(MetricsRegion)) {
+            close(fd);
+            throw std::runtime_error("shared memory " + name + " is not a metrics region of this version");
+        }
+    }
+
+    void *p = mmap(nullptr, sizeof(MetricsRegion), create ? PROT_READ | PROT_WRITE : PROT_READ,
+                   MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        if (create) shm_unlink(name.c_str());
+        fail("cannot map shared memory", name);
+    }
+
+    if (create) {
+        region_ = new (p) MetricsRegion();
+        region_->version = kMetricsVersion;
+        region_->size = sizeof(MetricsRegion);
+        region_->pid = static_cast<uint32_t>(getpid());
+        region_->magic.store(kMetricsMagic, std::memory_order_release);
+        owner_ = true;
+        return;
+    }
+
+    region_ = static_cast<MetricsRegion *>(p);
+    if (region_->magic.load(std::memory_order_acquire) != kMetricsMagic ||
+        region_->version != kMetricsVersion || region_->size != sizeof(MetricsRegion)) {
+        munmap(p, sizeof(MetricsRegion));
+        region_ = nullptr;
+        throw std::runtime_error("shared memory " + name + " is not a metrics region of this version");
+    }
+}
+
+SharedMetrics::~SharedMetrics() {
+    if (!region_) return;
+    if (owner_) region_->running.store(0, std::memory_order_relaxed);
+    munmap(region_, sizeof(MetricsRegion));
+    if (owner_) shm_unlink(name_.c_str());
+}
+
+#else
+
+SharedMetrics::SharedMetrics(const std::string &name, Mode) : name_(name) {
+    errno = ENOSYS;
+    fail("shared-memory metrics are not supported on this platform:", name);
+}
+
+SharedMetrics::~SharedMetrics() = default;
+
+#endif
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file shm_metrics.h
+ * @brief Live metrics published in a POSIX shared-memory region
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Lets external monitors (ffp-stat, agents) watch a running benchmark:
+ * the pipeline threads update counters, gauges and a latency histogram in a
+ * versioned shared-memory region with relaxed atomic stores, and readers map
+ * the region read-only and sample it at their own pace.
+ */
+
+/// @brief Region identifier ("FFPM")
+inline constexpr uint32_t kMetricsMagic = 0x4D504646;
+
+/// @brief Layout version; bump on any change to MetricsRegion
+inline constexpr uint32_t kMetricsVersion = 2;
+
+/// @brief Default shared-memory object name
+inline constexpr const char *kMetricsDefaultName = "/ffp-metrics";
+
+/// @brief Latency histogram buckets: 8 linear sub-buckets per power of two
+inline constexpr size_t kMetricsLatencyBuckets = 512;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory metrics require lock-free 64-bit atomics");
+
+/**
+ * @struct MetricsRegion
+ * @brief Memory layout of the shared metrics region
+ *
+ * Each counter has exactly one writer thread, which updates it with a relaxed
+ * load and store (no read-modify-write), so publishing costs the hot path one
+ * uncontended store. Writers sit on separate cache lines. Readers tolerate
+ * torn views across fields: every field is individually atomic, and rates are
+ * computed from differences between samples.
+ *
+ * The header is written once by the creator before it stores magic with
+ * release semantics; readers check magic, version and size before using
+ * anything else.
+ */
+struct MetricsRegion {
+    // Header (immutable once magic is set)
+    std::atomic<uint32_t> magic{0};   ///< kMetricsMagic once initialized
+    uint32_t version = 0;             ///< kMetricsVersion
+    uint32_t size = 0;                ///< sizeof(MetricsRegion)
+    uint32_t pid = 0;                 ///< Writer process id
+
+    // Reporter thread (run configuration is valid once running is 1)
+    alignas(64) std::atomic<uint64_t> target_rate{0};   ///< Configured messages per second
+    std::atomic<uint64_t> queue_capacity{0};            ///< Main queue capacity
+    std::atomic<uint64_t> heartbeat_ns{0};              ///< Reporter clock, updated every interval
+    std::atomic<uint64_t> queue_depth{0};               ///< Main queue depth at the last interval
+    std::atomic<uint32_t> running{0};                   ///< 1 while the benchmark runs
+
+    // Producer thread
+    alignas(64) std::atomic<uint64_t> produced{0};      ///< Messages generated
+
+    // Arbiter thread (--ab)
+    alignas(64) std::atomic<uint64_t> arb_duplicates{0}; ///< Redundant copies dropped
+    std::atomic<uint64_t> arb_stale{0};                 ///< Copies older than the window (dropped)
+    std::atomic<uint64_t> arb_lost{0};                  ///< Sequences missing on both lines
+
+    // Consumer thread
+    alignas(64) std::atomic<uint64_t> consumed{0};      ///< Messages delivered
+    std::atomic<uint64_t> latency_max_ns{0};            ///< Largest latency so far
+    std::atomic<uint64_t> latency_sum_ns{0};            ///< Sum of all latencies
+    std::atomic<uint64_t> reorder_late{0};              ///< Messages behind the delivery point (dropped)
+    std::atomic<uint64_t> reorder_skipped{0};           ///< Sequence gaps given up on
+    alignas(64) std::atomic<uint64_t> latency[kMetricsLatencyBuckets] = {};  ///< Latency counts per bucket
+
+    /**
+     * @brief Adds one latency sample to the histogram (consumer thread only)
+     */
+    void record_latency(uint64_t ns) noexcept {
+        std::atomic<uint64_t> &b = latency[latency_bucket(ns)];
+        b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        latency_sum_ns.store(latency_sum_ns.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        if (ns > latency_max_ns.load(std::memory_order_relaxed)) {
+            latency_max_ns.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Histogram bucket of @p ns (relative width at most 1/8)
+    static size_t latency_bucket(uint64_t ns) noexcept {
+        if (ns < 8) return static_cast<size_t>(ns);
+        unsigned e = static_cast<unsigned>(std::bit_width(ns)) - 1;   // e >= 3
+        uint64_t sub = (ns >> (e - 3)) & 7;
+        return static_cast<size_t>(e - 2) * 8 + static_cast<size_t>(sub);
+    }
+
+    /// @brief Smallest value that falls into bucket @p i
+    static uint64_t bucket_lower(size_t i) noexcept {
+        if (i < 8) return i;
+        unsigned e = static_cast<unsigned>(i / 8) + 2;
+        return (8 + uint64_t{i % 8}) << (e - 3);
+    }
+};
+
+/**
+ * @class SharedMetrics
+ * @brief Owns a mapping of a MetricsRegion
+ *
+ * Created by the benchmark (read-write, unlinked again on destruction) or
+ * attached by a monitor (read-only).
+ *
+ * @note Available on POSIX systems; the constructor throws elsewhere.
+ */
+class SharedMetrics {
+public:
+    enum class Mode { Create, Attach };
+
+    /**
+     * @brief Creates or attaches the region @p name
+     *
+     * @param name Shared-memory object name, e.g. "/ffp-metrics"
+     * @param mode Create (replaces an existing object only if it is a
+     *             metrics region whose writer has stopped or died) or Attach
+     *             (read-only)
+     *
+     * @throws std::runtime_error if the object cannot be opened or mapped, if
+     *         a region to be created is still in use by a running instance or
+     *         is not a metrics region, or if an attached region has the wrong
+     *         magic, version or size
+     */
+    SharedMetrics(const std::string &name, Mode mode);
+    ~SharedMetrics();
+
+    SharedMetrics(const SharedMetrics &) = delete;
+    SharedMetrics &operator=(const SharedMetrics &) = delete;
+
+    /// @brief The mapped region (writable only in Create mode)
+    MetricsRegion &region() noexcept {
+        return *region_;
+    }
+
+    /// @brief The mapped region
+    const MetricsRegion &region() const noexcept {
+        return *region_;
+    }
+
+    /// @brief Object name
+    const std::string &name() const noexcept {
+        return name_;
+    }
+
+private:
+    std::string name_;
+    MetricsRegion *region_ = nullptr;
+    bool owner_ = false;
+};
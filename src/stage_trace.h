@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "hdr_histogram.h"
+
+/**
+ * @file stage_trace.h
+ * @brief Sampled per-stage latency decomposition
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Splits end-to-end latency into the time spent generating, waiting in the
+ * queue, decoding and handing off downstream, by timestamping a sample of
+ * messages at every pipeline boundary. The timestamps travel in a side table
+ * indexed by sequence number, so RawMsg stays 32 bytes.
+ */
+
+/**
+ * @enum TraceStage
+ * @brief Pipeline boundaries at which a traced message is timestamped
+ */
+enum class TraceStage : unsigned {
+    Generate = 0,  ///< Producer starts building the message
+    Enqueue,       ///< Producer hands the message to the queue
+    Dequeue,       ///< Consumer pops the message
+    Decoded,       ///< Consumer has parsed the message into a Tick
+    Sunk,          ///< Consumer has finished recording the message
+    Count
+};
+
+/**
+ * @class StageTracer
+ * @brief Seq-indexed side table of stage timestamps with per-stage histograms
+ *
+ * One message in every sample_every (a power of two) is traced. The producer
+ * stamps Generate and Enqueue into slot (seq / sample_every) & (slots - 1)
+ * before pushing the message; the consumer adds Dequeue, Decoded and Sunk and
+ * then records the four stage durations and the Generate-to-Sunk total.
+ *
+ * Slots are written by the producer under a per-slot sequence tag
+ * (seqlock): the tag is cleared, the stamps are written, and the tag is set
+ * to the message's sequence with release semantics. The consumer validates
+ * the tag before and after reading; if the producer has already lapped the
+ * slot (more than slots * sample_every messages in flight), the sample is
+ * dropped and counted in overruns().
+ *
+ * Queue wait (Enqueue to Dequeue) includes any time the producer spent
+ * blocked on a full queue, and, with --ab, the arbitration hop. Decode
+ * (Dequeue to Decoded) includes any time spent in the reorder window.
+ *
+ * @note Exactly one producer thread and one consumer thread. Histograms are
+ *       owned by the consumer; read them only after it has been joined.
+ */
+class StageTracer {
+public:
+    static constexpr size_t kStages = static_cast<size_t>(TraceStage::Count);
+    static constexpr size_t kIntervals = kStages - 1;  ///< Durations between consecutive stages
+
+    /**
+     * @brief Constructs a tracer
+     *
+     * @param sample_every Trace one message in this many (power of two >= 1)
+     * @param slots Side-table slots (power of two >= 1)
+     * @param significant_digits Precision of the stage histograms (1 to 5)
+     *
+     * @throws std::invalid_argument if a size is not a power of two
+     */
+    explicit StageTracer(uint64_t sample_every, size_t slots = 4096, int significant_digits = 3)
+        : sample_mask_(sample_every - 1),
+          sample_shift_(std::countr_zero(sample_every)),
+          slot_mask_(slots - 1),
+          slots_(std::make_unique<Slot[]>(slots)),
+          stage_hist_(make_histograms(significant_digits)),
+          total_hist_(3'600'000'000'000ULL, significant_digits) {
+        if (!std::has_single_bit(sample_every) || !std::has_single_bit(slots)) {
+            throw std::invalid_argument("trace sample rate and slot count must be powers of two");
+        }
+    }
+
+    StageTracer(const StageTracer &) = delete;
+    StageTracer &operator=(const StageTracer &) = delete;
+
+    /// @brief True if message @p seq is traced
+    bool sampled(uint64_t seq) const noexcept {
+        return (seq & sample_mask_) == 0;
+    }
+
+    /**
+     * @brief Publishes the producer stamps of a traced message (producer thread)
+     *
+     * Call before the message is pushed, so the queue's release/acquire
+     * makes the stamps visible to the consumer that pops it.
+     */
+    void begin(uint64_t seq, uint64_t t_generate, uint64_t t_enqueue) noexcept {
+        Slot &s = slot(seq);
+        s.tag.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.t[0].store(t_generate, std::memory_order_relaxed);
+        s.t[1].store(t_enqueue, std::memory_order_relaxed);
+        s.tag.store(seq, std::memory_order_release);
+    }
+
+    /**
+     * @brief Stamps a consumer-side stage of a traced message (consumer thread)
+     *
+     * @param seq Sequence number (must satisfy sampled())
+     * @param stage Dequeue or Decoded
+     * @param t_ns Timestamp
+     */
+    void stamp(uint64_t seq, TraceStage stage, uint64_t t_ns) noexcept {
+        slot(seq).t[static_cast<size_t>(stage)].store(t_ns, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Stamps Sunk and records the stage durations (consumer thread)
+     *
+     * @return false if the slot was overwritten before it could be read
+     */
+    bool finish(uint64_t seq, uint64_t t_sunk) noexcept {
+        Slot &s = slot(seq);
+        if (s.tag.load(std::memory_order_acquire) != seq) {
+            ++overruns_;
+            return false;
+        }
+        std::array<uint64_t, kStages> t;
+        for (size_t i = 0; i + 1 < kStages; ++i) t[i] = s.t[i].load(std::memory_order_relaxed);
+        t[kStages - 1] = t_sunk;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.tag.load(std::memory_order_relaxed) != seq) {
+            ++overruns_;
+            return false;
+        }
+        for (size_t i = 0; i < kIntervals; ++i) {
+            stage_hist_[i].record(t[i + 1] > t[i] ? t[i + 1] - t[i] : 0);
+        }
+        total_hist_.record(t_sunk > t[0] ? t_sunk - t[0] : 0);
+        return true;
+    }
+
+    /// @brief Histogram of the duration from stage @p i to stage i + 1
+    const LatencyHistogram &stage_histogram(size_t i) const noexcept {
+        return stage_hist_[i];
+    }
+
+    /// @brief Histogram of Generate to Sunk for traced messages
+    const LatencyHistogram &total_histogram() const noexcept {
+        return total_hist_;
+    }
+
+    /// @brief Traced samples dropped because their slot was reused too early
+    uint64_t overruns() const noexcept {
+        return overruns_;
+    }
+
+    /// @brief Trace one message in this many
+    uint64_t sample_every() const noexcept {
+        return sample_mask_ + 1;
+    }
+
+    /// @brief Name of the duration from stage @p i to stage i + 1
+    static const char *interval_name(size_t i) noexcept {
+        static const char *const names[kIntervals] = {"generate", "queue wait", "decode", "sink"};
+        return i < kIntervals ? names[i] : "?";
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> tag{0};                               ///< Seq owning the stamps (0 = writing)
+        std::array<std::atomic<uint64_t>, kStages - 1> t{};         ///< Stamps up to Decoded
+    };
+
+    static std::array<LatencyHistogram, kIntervals> make_histograms(int digits) {
+        static_assert(kIntervals == 4, "one histogram per stage interval");
+        LatencyHistogram h(3'600'000'000'000ULL, digits);
+        return {h, h, h, h};
+    }
+
+    Slot &slot(uint64_t seq) noexcept {
+        return slots_[(seq >> sample_shift_) & slot_mask_];
+    }
+
+    uint64_t sample_mask_;                                  ///< sample_every - 1
+    int sample_shift_;                                      ///< log2(sample_every)
+    size_t slot_mask_;                                      ///< slots - 1
+    std::unique_ptr<Slot[]> slots_;                         ///< Side table shared by producer and consumer
+    std::array<LatencyHistogram, kIntervals> stage_hist_;   ///< Consumer: per-stage durations
+    LatencyHistogram total_hist_;                           ///< Consumer: Generate to Sunk
+    uint64_t overruns_ = 0;                                 ///< Consumer: dropped samples
+};
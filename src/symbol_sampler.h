@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file symbol_sampler.h
+ * @brief Zipf-distributed symbol ids in constant time per draw
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Real feeds are heavily skewed: a few dozen names carry most of the
+ * traffic. SymbolSampler gives the symbol of popularity rank k the weight
+ * 1 / k^s and draws from it with Vose's alias method: one 64-bit random
+ * number picks a column and decides between the column's own symbol and its
+ * alias, so a draw is a multiply, a compare and one cache-line read whatever
+ * the universe size. Ranks are mapped to symbol ids through a fixed random
+ * permutation, so the hot names are scattered over the id space (and over
+ * consumer shards) as they are on a real exchange.
+ *
+ * A sampler can also cover one slice of a larger universe: given the ranks
+ * first_rank, first_rank + rank_stride, ... it draws from the Zipf weights of
+ * those ranks only. Slices that together hold every rank, each sending at a
+ * rate proportional to its mass(), add up to Zipf(s) over the whole universe.
+ */
+
+/**
+ * @class SymbolSampler
+ * @brief Alias-table sampler of Zipf-distributed symbol ids 1..universe
+ */
+class SymbolSampler {
+public:
+    /// @brief Largest supported universe
+    static constexpr uint32_t kMaxUniverse = 1u << 20;
+
+    /**
+     * @param universe Number of symbols (ids 1..universe)
+     * @param skew Zipf exponent s (0 = uniform; about 1 for equity feeds)
+     * @param seed Seed of the rank-to-id permutation
+     * @param first_rank Popularity rank (1-based) of the slice's most popular symbol
+     * @param rank_stride Step between the slice's ranks
+     * @throws std::invalid_argument if universe is 0 or above kMaxUniverse, skew is negative,
+     *         or first_rank or rank_stride is 0
+     */
+    SymbolSampler(uint32_t universe, double skew, uint64_t seed = 0x9E3779B97F4A7C15ULL, uint32_t first_rank = 1,
+                  uint32_t rank_stride = 1)
+        : universe_(universe), skew_(skew), first_rank_(first_rank), rank_stride_(rank_stride) {
+        if (universe == 0 || universe > kMaxUniverse) {
+            throw std::invalid_argument("symbol universe must be 1 to " + std::to_string(kMaxUniverse));
+        }
+        if (!(skew >= 0.0)) throw std::invalid_argument("Zipf skew must be non-negative");
+        if (first_rank == 0 || rank_stride == 0) throw std::invalid_argument("Zipf ranks start at 1");
+        columns_.resize(universe);
+
+        // Rank k (0-based) -> symbol id, Fisher-Yates with xorshift64*
+        std::vector<uint32_t> ids(universe);
+        for (uint32_t k = 0; k < universe; ++k) ids[k] = k + 1;
+        uint64_t s = seed ? seed : 1;
+        for (uint32_t k = universe - 1; k > 0; --k) {
+            s ^= s >> 12;
+            s ^= s << 25;
+            s ^= s >> 27;
+            const uint32_t j = static_cast<uint32_t>(((s * 0x2545F4914F6CDD1DULL) >> 32) * (k + 1) >> 32);
+            std::swap(ids[k], ids[j]);
+        }
+
+        // Vose: scale weights to mean 1, pair every light column with a heavy one
+        std::vector<double> p(universe);
+        double total = 0.0;
+        for (uint32_t k = 0; k < universe; ++k) total += p[k] = std::pow(rank(k), -skew);
+        weights_total_ = total;
+        std::vector<uint32_t> small, large;
+        for (uint32_t k = 0; k < universe; ++k) {
+            p[k] *= universe / total;
+            (p[k] < 1.0 ? small : large).push_back(k);
+        }
+        while (!small.empty() && !large.empty()) {
+            const uint32_t l = small.back(), g = large.back();
+            small.pop_back();
+            columns_[l] = {threshold(p[l]), ids[l], ids[g]};
+            p[g] -= 1.0 - p[l];
+            if (p[g] < 1.0) {
+                large.pop_back();
+                small.push_back(g);
+            }
+        }
+        // Leftovers are 1 up to rounding: always their own symbol
+        for (uint32_t k : large) columns_[k] = {UINT32_MAX, ids[k], ids[k]};
+        for (uint32_t k : small) columns_[k] = {UINT32_MAX, ids[k], ids[k]};
+    }
+
+    /**
+     * @brief Draws a symbol id from 64 uniformly random bits
+     *
+     * The high half picks the column, the low half decides between its symbol and its alias.
+     */
+    uint32_t operator()(uint64_t r) const noexcept {
+        const Column &c = columns_[((r >> 32) * universe_) >> 32];
+        return static_cast<uint32_t>(r) < c.threshold ? c.id : c.alias;
+    }
+
+    /// @brief Share of all draws that fall on the @p k most popular symbols
+    double top_share(uint32_t k) const noexcept {
+        double s = 0.0;
+        for (uint32_t i = 0; i < k && i < universe_; ++i) s += std::pow(rank(i), -skew_);
+        return s / weights_total_;
+    }
+
+    /// @brief Sum of the Zipf weights 1 / rank^s of this sampler's ranks
+    double mass() const noexcept { return weights_total_; }
+
+    uint32_t universe() const noexcept { return universe_; }
+    double skew() const noexcept { return skew_; }
+
+private:
+    struct Column {
+        uint32_t threshold;  // P(own symbol) * 2^32
+        uint32_t id;         // Symbol of this column
+        uint32_t alias;      // Symbol drawn otherwise
+    };
+
+    // Universe-wide popularity rank of the k-th (0-based) symbol of this slice
+    double rank(uint32_t k) const noexcept {
+        return first_rank_ + static_cast<double>(k) * rank_stride_;
+    }
+
+    static uint32_t threshold(double p) noexcept {
+        const double t = p * 4294967296.0;
+        return t >= 4294967295.0 ? UINT32_MAX : static_cast<uint32_t>(t);
+    }
+
+    uint32_t universe_;
+    double skew_;
+    uint32_t first_rank_;
+    uint32_t rank_stride_;
+    double weights_total_ = 0.0;
+    std::vector<Column> columns_;
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file symbol_stats.h
+ * @brief Per-symbol message counts and latency histograms
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Latency problems are often specific to an instrument. SymbolStats keeps a
+ * message count, a maximum and a small log-bucket histogram for every
+ * symbol_id in flat arrays indexed by symbol, so recording is a few array
+ * increments with no hashing or allocation; the end-of-run report ranks the
+ * symbols by volume and by p99.
+ *
+ * Histograms are 1.25 KB each, too much for every id of a large universe,
+ * so they are handed out in order of first appearance from a fixed pool;
+ * under a skewed feed the busy symbols appear first and get one. Counts and
+ * maxima are kept for every symbol.
+ */
+
+/**
+ * @struct SymbolSummary
+ * @brief One symbol's totals for the report
+ */
+struct SymbolSummary {
+    uint32_t symbol_id = 0;  ///< Instrument (the overflow row reports capacity())
+    uint64_t count = 0;      ///< Messages delivered
+    uint64_t p50 = 0;        ///< Median latency (bucket upper bound)
+    uint64_t p99 = 0;        ///< 99th percentile latency (bucket upper bound)
+    uint64_t max = 0;        ///< Maximum latency (exact)
+};
+
+/**
+ * @class SymbolStats
+ * @brief Flat per-symbol recorder
+ *
+ * Histograms have 4 linear sub-buckets per power of two (relative width at
+ * most 1/4) up to 2^40 ns; percentiles are reported as bucket upper bounds,
+ * and as 0 for symbols that found the histogram pool exhausted. Symbols at
+ * or above the capacity share one overflow row.
+ *
+ * @note Not thread-safe. One recorder belongs to one consumer thread; shard
+ *       recorders are combined with merge().
+ */
+class SymbolStats {
+public:
+    /// @brief Histogram buckets per symbol
+    static constexpr size_t kBuckets = 160;
+
+    /**
+     * @param capacity Number of symbol ids tracked individually (0..capacity-1)
+     * @param histograms Histogram pool size (0 = one per row)
+     * @throws std::invalid_argument if capacity is 0
+     */
+    explicit SymbolStats(size_t capacity, size_t histograms = 0)
+        : capacity_(capacity), count_(capacity + 1), max_(capacity + 1), slot_(capacity + 1, kNoSlot),
+          histograms_(histograms && histograms < capacity + 1 ? histograms : capacity + 1),
+          buckets_(histograms_ * kBuckets) {
+        if (capacity == 0) throw std::invalid_argument("symbol capacity must be positive");
+    }
+
+    /// @brief Records one message of @p symbol_id with latency @p ns
+    void record(uint32_t symbol_id, uint64_t ns) noexcept {
+        const size_t row = std::min<size_t>(symbol_id, capacity_);
+        ++count_[row];
+        if (ns > max_[row]) max_[row] = ns;
+        uint32_t s = slot_[row];
+        if (s == kNoSlot) [[unlikely]] {
+            if (used_ == histograms_) return;
+            s = slot_[row] = static_cast<uint32_t>(used_++);
+        }
+        ++buckets_[s * kBuckets + bucket(ns)];
+    }
+
+    /// @brief Adds the counts of @p other (same capacity)
+    /// @throws std::invalid_argument on a capacity mismatch
+    void merge(const SymbolStats &other) {
+        if (other.capacity_ != capacity_) throw std::invalid_argument("cannot merge symbol stats of different capacity");
+        for (size_t i = 0; i <= capacity_; ++i) {
+            count_[i] += other.count_[i];
+            max_[i] = std::max(max_[i], other.max_[i]);
+            if (other.slot_[i] == kNoSlot) continue;
+            if (slot_[i] == kNoSlot) {
+                if (used_ == histograms_) continue;
+                slot_[i] = static_cast<uint32_t>(used_++);
+            }
+            const uint64_t *src = &other.buckets_[other.slot_[i] * kBuckets];
+            uint64_t *dst = &buckets_[slot_[i] * kBuckets];
+            for (size_t b = 0; b < kBuckets; ++b) dst[b] += src[b];
+        }
+    }
+
+    /// @brief Totals of row @p row (capacity() is the overflow row)
+    SymbolSummary summary(size_t row) const noexcept {
+        SymbolSummary s;
+        s.symbol_id = static_cast<uint32_t>(row);
+        s.count = count_[row];
+        s.p50 = quantile(row, 0.50);
+        s.p99 = quantile(row, 0.99);
+        s.max = max_[row];
+        return s;
+    }
+
+    /**
+     * @brief The @p n busiest symbols, most messages first
+     */
+    std::vector<SymbolSummary> top_by_volume(size_t n) const {
+        return top(n, 0, false, [](const SymbolSummary &a, const SymbolSummary &b) {
+            return a.count != b.count ? a.count > b.count : a.symbol_id < b.symbol_id;
+        });
+    }
+
+    /**
+     * @brief The @p n symbols with the highest p99, among those with at least
+     *        @p min_count messages (fewer make a p99 meaningless)
+     */
+    std::vector<SymbolSummary> top_by_p99(size_t n, uint64_t min_count = 100) const {
+        return top(n, min_count, true, [](const SymbolSummary &a, const SymbolSummary &b) {
+            return a.p99 != b.p99 ? a.p99 > b.p99 : a.count > b.count;
+        });
+    }
+
+    /// @brief Number of symbols with at least one message
+    size_t active() const noexcept {
+        return static_cast<size_t>(std::count_if(count_.begin(), count_.end(), [](uint64_t c) { return c != 0; }));
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+    /// @brief Bytes held by the recorder
+    size_t memory_bytes() const noexcept {
+        return (capacity_ + 1) * (2 * sizeof(uint64_t) + sizeof(uint32_t)) + histograms_ * kBuckets * sizeof(uint64_t);
+    }
+
+    /// @brief Bucket of @p ns
+    static size_t bucket(uint64_t ns) noexcept {
+        if (ns < 4) return static_cast<size_t>(ns);
+        unsigned e = static_cast<unsigned>(std::bit_width(ns)) - 1;  // e >= 2
+        if (e > 40) return kBuckets - 1;
+        uint64_t sub = (ns >> (e - 2)) & 3;
+        return std::min(static_cast<size_t>(e - 1) * 4 + static_cast<size_t>(sub), kBuckets - 1);
+    }
+
+    /// @brief Largest value that falls into bucket @p i
+    static uint64_t bucket_upper(size_t i) noexcept {
+        if (i < 4) return i;
+        unsigned e = static_cast<unsigned>(i / 4) + 1;
+        return ((5 + uint64_t{i % 4}) << (e - 2)) - 1;
+    }
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    uint64_t quantile(size_t row, double q) const noexcept {
+        if (slot_[row] == kNoSlot) return 0;
+        const uint64_t *b = &buckets_[slot_[row] * kBuckets];
+        uint64_t n = 0;
+        for (size_t i = 0; i < kBuckets; ++i) n += b[i];
+        if (n == 0) return 0;
+        const uint64_t rank = static_cast<uint64_t>(q * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += b[i];
+            if (seen >= rank) return std::min(bucket_upper(i), max_[row]);
+        }
+        return max_[row];
+    }
+
+    template <class Less>
+    std::vector<SymbolSummary> top(size_t n, uint64_t min_count, bool need_histogram, Less less) const {
+        std::vector<SymbolSummary> all;
+        for (size_t i = 0; i <= capacity_; ++i) {
+            if (count_[i] && count_[i] >= min_count && (!need_histogram || slot_[i] != kNoSlot)) {
+                all.push_back(summary(i));
+            }
+        }
+        n = std::min(n, all.size());
+        std::partial_sort(all.begin(), all.begin() + n, all.end(), less);
+        all.resize(n);
+        return all;
+    }
+
+    size_t capacity_;
+    std::vector<uint64_t> count_;
+    std::vector<uint64_t> max_;
+    std::vector<uint32_t> slot_;  // Histogram of each row, kNoSlot if none
+    size_t histograms_;
+    size_t used_ = 0;
+    std::vector<uint64_t> buckets_;
+};
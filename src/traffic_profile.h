@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file traffic_profile.h
+ * @brief Time-varying message rates for the producer
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Real feeds average modest rates but arrive in microbursts of 10x-100x for
+ * hundreds of microseconds, at the open and on news. A TrafficProfile maps
+ * time since the start of the run to an instantaneous rate, as a multiple of
+ * the configured base rate; the Pacer turns it into send deadlines. Shapes:
+ *
+ *   constant                   the base rate throughout
+ *   bursts[:MULT:ON_US:EVERY_MS] MULT x the base rate for ON_US every EVERY_MS
+ *                              (default 50x for 200 us every 10 ms)
+ *   open[:MULT:SECONDS]        starts at MULT x and falls linearly to the base
+ *                              rate over SECONDS (default 10x over 2 s)
+ *   curve:PATH                 piecewise-linear multipliers from a file of
+ *                              "t_ms multiplier" lines, replayed in a loop
+ *                              whose length is the last point's time
+ */
+
+/**
+ * @class TrafficProfile
+ * @brief Rate as a function of time
+ */
+class TrafficProfile {
+public:
+    enum class Shape { Constant, Bursts, Open, Curve };
+
+    /// @brief The base rate throughout
+    TrafficProfile() = default;
+
+    /**
+     * @brief Parses a profile specification (see the file comment)
+     *
+     * @throws std::invalid_argument on a malformed specification or curve file
+     */
+    static TrafficProfile parse(const std::string &spec) {
+        TrafficProfile p;
+        std::vector<std::string> f;
+        std::stringstream ss(spec);
+        for (std::string part; std::getline(ss, part, ':');) f.push_back(part);
+        if (f.empty()) throw std::invalid_argument("empty traffic profile");
+        auto number = [&](size_t i, double dflt, double lo, double hi) {
+            if (i >= f.size()) return dflt;
+            char *end = nullptr;
+            double v = std::strtod(f[i].c_str(), &end);
+            if (f[i].empty() || *end || !(v >= lo && v <= hi)) {
+                throw std::invalid_argument("traffic profile " + spec + ": field " + std::to_string(i) +
+                                            " must be in [" + format(lo) + ", " + format(hi) + "]");
+            }
+            return v;
+        };
+        if (f[0] == "constant" && f.size() == 1) {
+            p.shape_ = Shape::Constant;
+        } else if (f[0] == "bursts" && (f.size() == 1 || f.size() == 4)) {
+            p.shape_ = Shape::Bursts;
+            p.mult_ = number(1, 50.0, 1.0, 10000.0);
+            p.on_ns_ = static_cast<uint64_t>(number(2, 200.0, 1.0, 60e6) * 1e3);
+            p.every_ns_ = static_cast<uint64_t>(number(3, 10.0, 0.001, 3.6e6) * 1e6);
+            if (p.on_ns_ >= p.every_ns_) {
+                throw std::invalid_argument("traffic profile " + spec + ": bursts must be shorter than their spacing");
+            }
+        } else if (f[0] == "open" && (f.size() == 1 || f.size() == 3)) {
+            p.shape_ = Shape::Open;
+            p.mult_ = number(1, 10.0, 1.0, 10000.0);
+            p.ramp_ns_ = static_cast<uint64_t>(number(2, 2.0, 0.001, 86400.0) * 1e9);
+        } else if (f[0] == "curve" && f.size() >= 2) {
+            p.shape_ = Shape::Curve;
+            p.load_curve(spec.substr(6));
+        } else {
+            throw std::invalid_argument("traffic profile must be constant, bursts[:MULT:ON_US:EVERY_MS], "
+                                        "open[:MULT:SECONDS] or curve:PATH");
+        }
+        p.spec_ = spec;
+        return p;
+    }
+
+    /**
+     * @brief Rate multiplier at @p t_ns since the start of the run
+     */
+    double multiplier(uint64_t t_ns) const noexcept {
+        switch (shape_) {
+        case Shape::Bursts:
+            return t_ns % every_ns_ < on_ns_ ? mult_ : 1.0;
+        case Shape::Open:
+            return t_ns >= ramp_ns_ ? 1.0 : mult_ - (mult_ - 1.0) * (static_cast<double>(t_ns) / ramp_ns_);
+        case Shape::Curve: {
+            const uint64_t t = t_ns % curve_.back().first;
+            auto hi = std::upper_bound(curve_.begin(), curve_.end(), t,
+                                       [](uint64_t v, const std::pair<uint64_t, double> &pt) { return v < pt.first; });
+            auto lo = hi - 1;
+            const double frac = static_cast<double>(t - lo->first) / (hi->first - lo->first);
+            return lo->second + (hi->second - lo->second) * frac;
+        }
+        case Shape::Constant:
+            break;
+        }
+        return 1.0;
+    }
+
+    /// @brief Largest multiplier the profile reaches
+    double peak() const noexcept {
+        if (shape_ == Shape::Bursts || shape_ == Shape::Open) return mult_;
+        if (shape_ == Shape::Curve) {
+            double m = 0.0;
+            for (const auto &pt : curve_) m = std::max(m, pt.second);
+            return m;
+        }
+        return 1.0;
+    }
+
+    Shape shape() const noexcept { return shape_; }
+    const std::string &spec() const noexcept { return spec_; }
+
+private:
+    static std::string format(double v) {
+        std::ostringstream os;
+        os << v;
+        return os.str();
+    }
+
+    void load_curve(const std::string &path) {
+        std::ifstream in(path);
+        if (!in) throw std::invalid_argument("cannot read traffic curve " + path);
+        std::string line;
+        for (size_t n = 1; std::getline(in, line); ++n) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream ls(line);
+            double t_ms = 0.0, m = 0.0;
+            if (!(ls >> t_ms >> m) || t_ms < 0.0 || m < 0.0) {
+                throw std::invalid_argument(path + ":" + std::to_string(n) + ": expected \"t_ms multiplier\"");
+            }
+            const uint64_t t_ns = static_cast<uint64_t>(t_ms * 1e6);
+            if (curve_.empty() ? t_ns != 0 : t_ns <= curve_.back().first) {
+                throw std::invalid_argument(path + ":" + std::to_string(n) +
+                                            ": times must start at 0 and increase");
+            }
+            curve_.emplace_back(t_ns, m);
+        }
+        if (curve_.size() < 2) throw std::invalid_argument(path + ": a curve needs at least two points");
+    }
+
+    Shape shape_ = Shape::Constant;
+    std::string spec_ = "constant";
+    double mult_ = 1.0;
+    uint64_t on_ns_ = 0;
+    uint64_t every_ns_ = 1;
+    uint64_t ramp_ns_ = 1;
+    std::vector<std::pair<uint64_t, double>> curve_;  // (t_ns, multiplier), t strictly increasing from 0
+};
@@ -7,6 +7,10 @@
 #include <numeric>
 #include <cmath>
 #include <iomanip>
+#include <thread>
+
+#include "ddsketch.h"
+#include "hdr_histogram.h"
 
 /**
  * @file util.h
@@ -28,8 +32,9 @@
  * in financial performance analysis and provides smooth percentile estimates.
  * 
  * The function creates a copy of the input vector for sorting, preserving
- * the original data order. For large datasets, consider using in-place
- * sorting if the original order is not needed.
+ * the original data order. When several percentiles of the same data are
+ * needed, use percentiles() instead: it selects all of them from a single
+ * copy in linear time.
  * 
  * @param v_in Input vector of values (will not be modified)
  * @param p Percentile to calculate (0.0 to 1.0, e.g., 0.95 for 95th percentile)
@@ -70,6 +75,252 @@ inline double percentile(const std::vector<uint64_t> &v_in, double p) {
     return v[lo] * (1.0 - frac) + v[hi] * frac;
 }
 
+/// Inputs at least this large use the parallel selection path of percentiles()
+constexpr size_t kParallelSelectThreshold = size_t{1} << 22;
+
+namespace detail {
+
+// Places each rank in [rb, re) (sorted, unique) of v[first, last) at its
+// sorted position with successive nth_element partitions: the middle rank
+// splits the range and the ranks on either side recurse into their half.
+inline void multi_select(std::vector<uint64_t> &v, size_t first, size_t last,
+                         const size_t *rb, const size_t *re) {
+    if (rb == re || last - first < 2) return;
+    const size_t *mid = rb + (re - rb) / 2;
+    std::nth_element(v.begin() + first, v.begin() + *mid, v.begin() + last);
+    multi_select(v, first, *mid, rb, mid);
+    multi_select(v, *mid + 1, last, mid + 1, re);
+}
+
+// One requested percentile: ranks r0 <= r1 = r0 or r0 + 1 (R-7 neighbours).
+struct SelectTarget {
+    size_t r0, r1;
+    uint64_t lo_val, hi_val;  // value band expected to contain both ranks
+    uint64_t v0, v1;          // selected values
+    bool found;
+};
+
+// Parallel sample-band selection. A sorted random sample predicts a narrow
+// value band around each target rank; threads then count the elements below
+// each band and collect the elements inside it in one pass over disjoint
+// chunks. Only the small bands are partitioned afterwards. Targets whose band
+// turns out not to contain their ranks keep found == false, and so do targets
+// whose band outgrows kBandCapDivisor: on inputs with long runs of equal
+// values a band can hold most of the input, and such targets are cheaper to
+// leave to the sequential selection than to copy.
+constexpr size_t kBandCapDivisor = 16;
+
+inline void band_select(const std::vector<uint64_t> &v, std::vector<SelectTarget> &targets,
+                        unsigned threads) {
+    const size_t n = v.size();
+    const size_t m = std::min<size_t>(n, size_t{1} << 16);
+    std::vector<uint64_t> sample(m);
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < m; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;  // xorshift64
+        sample[i] = v[x % n];
+    }
+    std::sort(sample.begin(), sample.end());
+
+    for (SelectTarget &t : targets) {
+        double p = static_cast<double>(t.r0) / n;
+        double pos = p * m;
+        double delta = 4.0 * std::sqrt(m * p * (1.0 - p)) + 16.0;
+        t.lo_val = pos - delta <= 0 ? 0 : sample[static_cast<size_t>(pos - delta)];
+        t.hi_val = pos + delta >= m - 1 ? UINT64_MAX : sample[static_cast<size_t>(pos + delta)];
+        t.found = false;
+    }
+
+    const size_t k = targets.size();
+    std::vector<std::vector<size_t>> below(threads, std::vector<size_t>(k, 0));
+    std::vector<std::vector<std::vector<uint64_t>>> bands(threads, std::vector<std::vector<uint64_t>>(k));
+    std::vector<std::vector<char>> overflow(threads, std::vector<char>(k, 0));
+    std::vector<std::thread> workers;
+    const size_t chunk = (n + threads - 1) / threads;
+    const size_t cap = chunk / kBandCapDivisor + 1;  // per thread and target
+    for (unsigned w = 0; w < threads; ++w) {
+        workers.emplace_back([&, w] {
+            size_t begin = std::min(n, w * chunk), end = std::min(n, begin + chunk);
+            for (size_t i = begin; i < end; ++i) {
+                uint64_t val = v[i];
+                for (size_t j = 0; j < k; ++j) {
+                    if (val < targets[j].lo_val) {
+                        ++below[w][j];
+                    } else if (val <= targets[j].hi_val && !overflow[w][j]) {
+                        if (bands[w][j].size() < cap) {
+                            bands[w][j].push_back(val);
+                        } else {
+                            overflow[w][j] = 1;
+                            std::vector<uint64_t>().swap(bands[w][j]);
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread &th : workers) th.join();
+
+    for (size_t j = 0; j < k; ++j) {
+        size_t lower = 0;
+        bool overflowed = false;
+        std::vector<uint64_t> band;
+        for (unsigned w = 0; w < threads; ++w) overflowed |= overflow[w][j] != 0;
+        if (overflowed) continue;
+        for (unsigned w = 0; w < threads; ++w) {
+            lower += below[w][j];
+            band.insert(band.end(), bands[w][j].begin(), bands[w][j].end());
+        }
+        SelectTarget &t = targets[j];
+        if (t.r0 < lower || t.r1 >= lower + band.size()) continue;
+        auto nth = band.begin() + (t.r0 - lower);
+        std::nth_element(band.begin(), nth, band.end());
+        t.v0 = *nth;
+        t.v1 = t.r1 == t.r0 ? t.v0 : *std::min_element(nth + 1, band.end());
+        t.found = true;
+    }
+}
+
+// Shared table layout for recorders exposing count/mean/max/value_at_quantile.
+template <typename Recorder>
+void print_recorder_stats(const Recorder &r) {
+    std::cout << "\n================================\n";
+    std::cout << "Latency Analysis Results\n";
+    std::cout << "================================\n";
+    if (r.count() == 0) {
+        std::cout << "No latency samples collected\n";
+        std::cout << "================================\n";
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Samples collected: " << std::setw(10) << r.count() << "\n";
+    std::cout << "Average latency:   " << std::setw(8) << (r.mean() / 1000.0) << " μs\n";
+    std::cout << "Median (p50):      " << std::setw(8) << (r.value_at_quantile(0.50) / 1000.0) << " μs\n";
+    std::cout << "90th percentile:   " << std::setw(8) << (r.value_at_quantile(0.90) / 1000.0) << " μs\n";
+    std::cout << "99th percentile:   " << std::setw(8) << (r.value_at_quantile(0.99) / 1000.0) << " μs\n";
+    std::cout << "99.9th percentile: " << std::setw(8) << (r.value_at_quantile(0.999) / 1000.0) << " μs\n";
+    std::cout << "Maximum latency:   " << std::setw(8) << (r.max() / 1000.0) << " μs\n";
+    std::cout << "================================\n";
+}
+
+}  // namespace detail
+
+/**
+ * @brief Calculates several percentiles from one dataset in a single pass
+ * 
+ * Returns the same values as calling percentile() once per entry of @p ps
+ * (R-7 linear interpolation), but without sorting: all required ranks are
+ * selected from one working copy using successive std::nth_element
+ * partitions, each confined to the sub-range left by the previous one.
+ * 
+ * Inputs of at least kParallelSelectThreshold samples are processed with a
+ * parallel sample-band selection when more than one thread is allowed: a
+ * random sample brackets every target rank with a narrow value band, worker
+ * threads count and collect band members over disjoint chunks, and only the
+ * bands are partitioned. No full copy of the input is made on that path; any
+ * percentile whose band misses, or holds more than n / 16 values (inputs
+ * with many duplicates), falls back to the sequential selection.
+ * 
+ * @param v_in Input values (not modified)
+ * @param ps Percentiles to calculate (each 0.0 to 1.0, any order)
+ * @param threads Worker threads for large inputs (0 = hardware concurrency,
+ *                1 = always sequential)
+ * @return One value per entry of @p ps, in the same order (all 0.0 if
+ *         @p v_in is empty)
+ * 
+ * @note Time complexity: O(n) expected for a fixed number of percentiles
+ * @note Space complexity: O(n) for the working copy on the sequential path;
+ *       at most n / 16 band values per percentile on the parallel path
+ *       (about n / 60 for the median of continuous data, less in the tails)
+ * 
+ * Example usage:
+ * @code
+ * std::vector<double> q = percentiles(latencies, {0.50, 0.99, 0.999});
+ * @endcode
+ */
+inline std::vector<double> percentiles(const std::vector<uint64_t> &v_in,
+                                       const std::vector<double> &ps,
+                                       unsigned threads = 0) {
+    std::vector<double> result(ps.size(), 0.0);
+    if (v_in.empty() || ps.empty()) {
+        return result;
+    }
+    const size_t n = v_in.size();
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<detail::SelectTarget> targets(ps.size());
+    for (size_t i = 0; i < ps.size(); ++i) {
+        double idx = std::clamp(ps[i], 0.0, 1.0) * (n - 1);
+        targets[i].r0 = static_cast<size_t>(std::floor(idx));
+        targets[i].r1 = static_cast<size_t>(std::ceil(idx));
+        targets[i].found = false;
+    }
+
+    if (threads > 1 && n >= kParallelSelectThreshold) {
+        detail::band_select(v_in, targets, threads);
+    }
+
+    std::vector<size_t> ranks;
+    for (const detail::SelectTarget &t : targets) {
+        if (t.found) continue;
+        ranks.push_back(t.r0);
+        ranks.push_back(t.r1);
+    }
+    if (!ranks.empty()) {
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        std::vector<uint64_t> v = v_in;
+        detail::multi_select(v, 0, n, ranks.data(), ranks.data() + ranks.size());
+        for (detail::SelectTarget &t : targets) {
+            if (t.found) continue;
+            t.v0 = v[t.r0];
+            t.v1 = v[t.r1];
+        }
+    }
+
+    for (size_t i = 0; i < ps.size(); ++i) {
+        const detail::SelectTarget &t = targets[i];
+        if (t.r0 == t.r1) {
+            result[i] = static_cast<double>(t.v0);
+            continue;
+        }
+        double frac = std::clamp(ps[i], 0.0, 1.0) * (n - 1) - t.r0;
+        result[i] = t.v0 * (1.0 - frac) + t.v1 * frac;
+    }
+    return result;
+}
+
+/**
+ * @brief Reads a percentile from a latency histogram
+ * 
+ * Histogram counterpart of the vector overload. The result is the upper
+ * edge of the histogram counter holding the percentile, so it is accurate
+ * to the histogram's configured number of significant digits.
+ * 
+ * @param h Histogram of recorded values
+ * @param p Percentile to read (0.0 to 1.0)
+ * @return Percentile value, or 0.0 if the histogram is empty
+ * 
+ * @note Time complexity: O(number of histogram counters), independent of
+ *       the number of recorded samples
+ */
+inline double percentile(const LatencyHistogram &h, double p) {
+    return static_cast<double>(h.value_at_quantile(p));
+}
+
+/**
+ * @brief Reads a percentile from a streaming quantile sketch
+ * 
+ * @param s Sketch of recorded values
+ * @param p Percentile to read (0.0 to 1.0)
+ * @return Percentile value within the sketch's relative accuracy, or 0.0
+ *         if the sketch is empty
+ */
+inline double percentile(const DDSketch &s, double p) {
+    return static_cast<double>(s.value_at_quantile(p));
+}
+
 /**
  * @brief Prints comprehensive latency statistics in a formatted table
  * 
@@ -95,9 +346,9 @@ inline double percentile(const std::vector<uint64_t> &v_in, double p) {
  *       instead of attempting calculations.
  * 
  * Performance considerations:
- * - Time complexity: O(n log n) due to percentile calculations
- * - Memory usage: O(n) for sorting operations in percentile function
- * - For very large datasets (>1M samples), consider sampling for display
+ * - Time complexity: O(n); all percentiles come from one percentiles() call
+ * - Memory usage: O(n) for the selection working copy (less on the parallel
+ *   path used for very large datasets)
  * 
  * Example output:
  * @code
@@ -125,6 +376,7 @@ inline void print_stats(const std::vector<uint64_t> &lat) {
     
     // Calculate statistics
     double avg = std::accumulate(lat.begin(), lat.end(), 0.0) / lat.size();
+    std::vector<double> q = percentiles(lat, {0.50, 0.90, 0.99, 0.999});
     
     // Format output with proper alignment and precision
     std::cout << std::fixed << std::setprecision(2);
@@ -133,9 +385,34 @@ inline void print_stats(const std::vector<uint64_t> &lat) {
     std::cout << "================================\n";
     std::cout << "Samples collected: " << std::setw(10) << lat.size() << "\n";
     std::cout << "Average latency:   " << std::setw(8) << (avg / 1000.0) << " μs\n";
-    std::cout << "Median (p50):      " << std::setw(8) << (percentile(lat, 0.50) / 1000.0) << " μs\n";
-    std::cout << "90th percentile:   " << std::setw(8) << (percentile(lat, 0.90) / 1000.0) << " μs\n";
-    std::cout << "99th percentile:   " << std::setw(8) << (percentile(lat, 0.99) / 1000.0) << " μs\n";
-    std::cout << "99.9th percentile: " << std::setw(8) << (percentile(lat, 0.999) / 1000.0) << " μs\n";
+    std::cout << "Median (p50):      " << std::setw(8) << (q[0] / 1000.0) << " μs\n";
+    std::cout << "90th percentile:   " << std::setw(8) << (q[1] / 1000.0) << " μs\n";
+    std::cout << "99th percentile:   " << std::setw(8) << (q[2] / 1000.0) << " μs\n";
+    std::cout << "99.9th percentile: " << std::setw(8) << (q[3] / 1000.0) << " μs\n";
     std::cout << "================================\n";
 }
+
+/**
+ * @brief Prints latency statistics from a histogram in a formatted table
+ * 
+ * Same layout as the vector overload, with the maximum added. Percentiles
+ * are read from the histogram, so the cost does not depend on how many
+ * samples were recorded.
+ * 
+ * @param h Histogram of latency measurements in nanoseconds
+ */
+inline void print_stats(const LatencyHistogram &h) {
+    detail::print_recorder_stats(h);
+}
+
+/**
+ * @brief Prints latency statistics from a streaming sketch in a formatted table
+ * 
+ * Same layout as the histogram overload; percentiles carry the sketch's
+ * relative accuracy.
+ * 
+ * @param s Sketch of latency measurements in nanoseconds
+ */
+inline void print_stats(const DDSketch &s) {
+    detail::print_recorder_stats(s);
+}
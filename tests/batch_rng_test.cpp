@@ -0,0 +1,91 @@
+/**
+ * @file batch_rng_test.cpp
+ * @brief Regression tests for BatchRng
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "batch_rng.h"
+#include "symbol_sampler.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+// fill() (AVX2 when available) and fill_scalar() must produce the same feed.
+void vector_and_scalar_paths_match() {
+    for (bool sampler_bits : {false, true}) {
+        BatchRng vec(12345, 1000, sampler_bits), scalar(12345, 1000, sampler_bits);
+        MessageBatch a{}, b{};
+        for (int n = 0; n < 100; ++n) {
+            vec.fill(a);
+            scalar.fill_scalar(b);
+            CHECK(std::memcmp(a.symbol, b.symbol, sizeof a.symbol) == 0);
+            CHECK(std::memcmp(a.size, b.size, sizeof a.size) == 0);
+            CHECK(std::memcmp(a.price, b.price, sizeof a.price) == 0);
+            if (sampler_bits) CHECK(std::memcmp(a.bits, b.bits, sizeof a.bits) == 0);
+        }
+    }
+}
+
+// The sampler reads every bit of its draw (column and alias coin flip), so a
+// draw shared with size made each symbol's sizes depend on how it was drawn.
+// With a draw of its own, every popular symbol has the overall mean size.
+void size_is_independent_of_zipf_symbol() {
+    constexpr uint32_t kUniverse = 1000;
+    constexpr size_t kBatches = 40'000;  // 2.56M messages
+    SymbolSampler sampler(kUniverse, 1.0);
+    BatchRng rng(12345, kUniverse, true);
+    std::vector<uint64_t> count(kUniverse + 1), size_sum(kUniverse + 1);
+    MessageBatch b;
+    for (size_t n = 0; n < kBatches; ++n) {
+        rng.fill(b);
+        for (size_t i = 0; i < MessageBatch::kSize; ++i) {
+            const uint32_t symbol = sampler(b.bits[i]);
+            ++count[symbol];
+            size_sum[symbol] += b.size[i];
+        }
+    }
+    // Sizes are uniform in 1..1000: mean 500.5, standard deviation about 289.
+    // Symbols with 10000+ draws have a standard error below 3 on their mean.
+    size_t checked = 0;
+    for (uint32_t s = 1; s <= kUniverse; ++s) {
+        if (count[s] < 10'000) continue;
+        ++checked;
+        const double mean = static_cast<double>(size_sum[s]) / count[s];
+        if (std::fabs(mean - 500.5) > 20.0) {
+            std::fprintf(stderr, "symbol %u: mean size %.1f over %llu messages\n", s, mean,
+                         static_cast<unsigned long long>(count[s]));
+        }
+        CHECK(std::fabs(mean - 500.5) <= 20.0);
+    }
+    CHECK(checked >= 20);
+}
+
+}  // namespace
+
+int main() {
+    vector_and_scalar_paths_match();
+    size_is_independent_of_zipf_symbol();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("batch_rng: all checks passed");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file ddsketch_test.cpp
+ * @brief Accuracy and merge tests for DDSketch
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "ddsketch.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+constexpr size_t kSamples = 1'000'000;
+const double kQuantiles[] = {0.50, 0.90, 0.99, 0.999, 0.9999};
+
+struct Distribution {
+    const char *name;
+    std::function<uint64_t(std::mt19937_64 &)> draw;
+};
+
+const Distribution kDistributions[] = {
+    {"lognormal(4us)", [](std::mt19937_64 &r) {
+         return static_cast<uint64_t>(std::lognormal_distribution<double>(std::log(4000.0), 0.35)(r));
+     }},
+    {"uniform(1..1ms)", [](std::mt19937_64 &r) { return std::uniform_int_distribution<uint64_t>(1, 1'000'000)(r); }},
+    {"pareto(a=1.2)", [](std::mt19937_64 &r) {
+         double u = std::uniform_real_distribution<double>(1e-12, 1.0)(r);
+         return static_cast<uint64_t>(500.0 / std::pow(u, 1.0 / 1.2));
+     }},
+};
+
+std::vector<uint64_t> draw(const Distribution &d) {
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> samples(kSamples);
+    for (uint64_t &s : samples) s = d.draw(rng);
+    return samples;
+}
+
+// Every quantile is within the configured relative error of the exact
+// sample quantile, for 1% and 0.5% accuracy.
+void quantiles_within_relative_error() {
+    for (const Distribution &d : kDistributions) {
+        std::vector<uint64_t> samples = draw(d);
+        std::vector<uint64_t> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        for (double alpha : {0.01, 0.005}) {
+            DDSketch sketch(alpha);
+            for (uint64_t v : samples) sketch.record(v);
+            CHECK(sketch.count() == kSamples);
+            for (double q : kQuantiles) {
+                const double exact = static_cast<double>(sorted[static_cast<size_t>(q * (kSamples - 1))]);
+                const double est = static_cast<double>(sketch.value_at_quantile(q));
+                // +1 allows for rounding the bucket representative to an integer
+                if (std::fabs(est - exact) > alpha * exact + 1.0) {
+                    std::fprintf(stderr, "%s alpha %.3f q %.4f: exact %.0f, sketch %.0f\n", d.name, alpha, q, exact,
+                                 est);
+                }
+                CHECK(std::fabs(est - exact) <= alpha * exact + 1.0);
+            }
+        }
+    }
+}
+
+// Sketches of disjoint shards merge into exactly the single-sketch result.
+void merge_equals_single_sketch() {
+    for (const Distribution &d : kDistributions) {
+        std::vector<uint64_t> samples = draw(d);
+        DDSketch whole(0.01);
+        std::vector<DDSketch> shards(4, DDSketch(0.01));
+        for (size_t i = 0; i < samples.size(); ++i) {
+            whole.record(samples[i]);
+            shards[i % shards.size()].record(samples[i]);
+        }
+        DDSketch merged(0.01);
+        for (const DDSketch &s : shards) merged.merge(s);
+        CHECK(merged.count() == whole.count());
+        for (double q : kQuantiles) CHECK(merged.value_at_quantile(q) == whole.value_at_quantile(q));
+    }
+}
+
+}  // namespace
+
+int main() {
+    quantiles_within_relative_error();
+    merge_equals_single_sketch();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("ddsketch: all checks passed");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file hdr_histogram_test.cpp
+ * @brief Bucket layout, quantile, back-fill and merge tests for LatencyHistogram
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "hdr_histogram.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+const double kQuantiles[] = {0.50, 0.90, 0.99, 0.999, 0.9999};
+
+// Counters tile the value range without gaps or overlaps: each starts one
+// past the highest value of the previous one, and is no wider than the
+// configured precision allows.
+void counters_are_contiguous() {
+    for (int digits = 1; digits <= 5; ++digits) {
+        LatencyHistogram h(3'600'000'000'000ULL, digits);
+        const double precision = std::pow(10.0, -digits);
+        CHECK(h.value_at_index(0) == 0);
+        for (size_t i = 0; i + 1 < h.counts_size(); ++i) {
+            const uint64_t low = h.value_at_index(i);
+            const uint64_t high = h.highest_equivalent(low);
+            if (h.value_at_index(i + 1) != high + 1) {
+                std::fprintf(stderr, "digits %d counter %zu: [%llu, %llu], next starts at %llu\n", digits, i,
+                             static_cast<unsigned long long>(low), static_cast<unsigned long long>(high),
+                             static_cast<unsigned long long>(h.value_at_index(i + 1)));
+                CHECK(h.value_at_index(i + 1) == high + 1);
+                break;
+            }
+            CHECK(static_cast<double>(high - low) <= precision * std::max<uint64_t>(low, 1));
+        }
+    }
+}
+
+// value_at_quantile() is never below the exact sample quantile and at most
+// one precision step (10^-digits relative) above it.
+void quantiles_match_exact_within_precision() {
+    std::mt19937_64 rng(11);
+    std::lognormal_distribution<double> latency(std::log(20'000.0), 1.5);
+    std::vector<uint64_t> samples(500'000);
+    for (uint64_t &s : samples) s = static_cast<uint64_t>(latency(rng)) + 1;
+    std::vector<uint64_t> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    for (int digits = 1; digits <= 4; ++digits) {
+        LatencyHistogram h(3'600'000'000'000ULL, digits);
+        for (uint64_t v : samples) h.record(v);
+        CHECK(h.count() == samples.size());
+        CHECK(h.min() == sorted.front());
+        CHECK(h.max() == sorted.back());
+        for (double q : {0.0, 0.25, 0.50, 0.90, 0.99, 0.999, 0.9999, 1.0}) {
+            const auto rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+            const uint64_t exact = sorted[rank ? rank - 1 : 0];
+            const uint64_t est = h.value_at_quantile(q);
+            CHECK(est >= exact);
+            CHECK(static_cast<double>(est - exact) <= std::pow(10.0, -digits) * exact);
+        }
+    }
+}
+
+// A stall hides stall / interval sends, back-filled one interval apart
+// below the measured latency; large stalls keep the count at bounded cost.
+void backfill_records_hidden_sends() {
+    LatencyHistogram small;  // values below 2048 are exact at 3 digits
+    small.record_backfill(1000, 100, 10);
+    CHECK(small.count() == 10);
+    CHECK(small.min() == 900);
+    CHECK(small.max() == 990);
+    CHECK(small.value_at_quantile(0.5) == 940);
+
+    LatencyHistogram none;
+    none.record_backfill(1000, 100, 0);  // no interval: no correction
+    none.record_backfill(1000, 9, 10);   // shorter than one interval
+    CHECK(none.count() == 0);
+
+    LatencyHistogram capped;  // the stall cannot hide more than the latency covers
+    capped.record_backfill(1000, 5000, 10);
+    CHECK(capped.count() == 100);
+
+    LatencyHistogram large;
+    const uint64_t value = 1'000'000'000, interval = 1000, hidden = 100'000;
+    large.record_backfill(value, hidden * interval, interval);
+    CHECK(large.count() == hidden);
+    // exact mean of the hidden latencies: value - interval * (hidden + 1) / 2
+    const double mean = value - interval * (hidden + 1) / 2.0;
+    CHECK(std::fabs(large.mean() - mean) <= 0.001 * mean);
+    CHECK(large.max() < value);
+    CHECK(large.min() >= value - hidden * interval);
+}
+
+// Histograms of disjoint shards merge into exactly the single-histogram result.
+void merge_equals_single_histogram() {
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> latency(std::log(4000.0), 1.0);
+    LatencyHistogram whole;
+    std::vector<LatencyHistogram> shards(4);
+    for (size_t i = 0; i < 1'000'000; ++i) {
+        const auto v = static_cast<uint64_t>(latency(rng));
+        whole.record(v);
+        shards[i % shards.size()].record(v);
+    }
+    LatencyHistogram merged;
+    for (const LatencyHistogram &h : shards) merged.merge(h);
+    CHECK(merged.count() == whole.count());
+    CHECK(merged.max() == whole.max());
+    for (double q : kQuantiles) CHECK(merged.value_at_quantile(q) == whole.value_at_quantile(q));
+
+    bool threw = false;
+    try {
+        merged.merge(LatencyHistogram(3'600'000'000'000ULL, 2));
+    } catch (const std::invalid_argument &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+}  // namespace
+
+int main() {
+    counters_are_contiguous();
+    quantiles_match_exact_within_precision();
+    backfill_records_hidden_sends();
+    merge_equals_single_histogram();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("hdr_histogram: all checks passed");
+    return EXIT_SUCCESS;
+}
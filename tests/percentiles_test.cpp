@@ -0,0 +1,147 @@
+/**
+ * @file percentiles_test.cpp
+ * @brief Tests for percentiles() against a full sort
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "util.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+const std::vector<double> kPercentiles = {0.0, 0.001, 0.25, 0.50, 0.90, 0.99, 0.999, 0.9999, 1.0};
+
+// Large enough for the parallel sample-band path, and not a multiple of the
+// thread count so the last chunk is short.
+constexpr size_t kLarge = kParallelSelectThreshold + 1234;
+
+// R-7 percentiles of a fully sorted copy, the reference for percentiles().
+std::vector<double> sorted_percentiles(std::vector<uint64_t> v, const std::vector<double> &ps) {
+    std::sort(v.begin(), v.end());
+    std::vector<double> out;
+    for (double p : ps) {
+        const double idx = p * (v.size() - 1);
+        const auto lo = static_cast<size_t>(std::floor(idx)), hi = static_cast<size_t>(std::ceil(idx));
+        out.push_back(lo == hi ? static_cast<double>(v[lo]) : v[lo] * (1.0 - (idx - lo)) + v[hi] * (idx - lo));
+    }
+    return out;
+}
+
+void check_equals_sort(const char *name, const std::vector<uint64_t> &v, unsigned threads) {
+    const std::vector<double> want = sorted_percentiles(v, kPercentiles);
+    const std::vector<double> got = percentiles(v, kPercentiles, threads);
+    CHECK(got.size() == want.size());
+    for (size_t i = 0; i < want.size() && i < got.size(); ++i) {
+        if (std::fabs(got[i] - want[i]) > 1e-9 * std::fabs(want[i])) {
+            std::fprintf(stderr, "%s, %u thread(s), p %.4f: sort %.3f, percentiles %.3f\n", name, threads,
+                         kPercentiles[i], want[i], got[i]);
+        }
+        CHECK(std::fabs(got[i] - want[i]) <= 1e-9 * std::fabs(want[i]));
+    }
+}
+
+std::vector<uint64_t> lognormal(size_t n) {
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> latency(std::log(4000.0), 1.0);
+    std::vector<uint64_t> v(n);
+    for (uint64_t &x : v) x = static_cast<uint64_t>(latency(rng));
+    return v;
+}
+
+// Eight distinct values: every band is a run of equal values far larger
+// than n / kBandCapDivisor.
+std::vector<uint64_t> few_values(size_t n) {
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> v(n);
+    for (uint64_t &x : v) x = 1000 + 100 * (rng() % 8);
+    return v;
+}
+
+// 90% of the samples share one value; the tails are continuous.
+std::vector<uint64_t> one_dominant_value(size_t n) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<uint64_t> tail(1, 1'000'000);
+    std::vector<uint64_t> v(n);
+    for (uint64_t &x : v) x = rng() % 10 ? 5000 : tail(rng);
+    return v;
+}
+
+// Sequential and parallel selection both equal the full sort, on
+// continuous data, on long runs of duplicates and on sorted input.
+void equals_full_sort() {
+    for (size_t n : {size_t{1}, size_t{2}, size_t{1001}, kLarge}) {
+        std::vector<uint64_t> sorted(n);
+        for (size_t i = 0; i < n; ++i) sorted[i] = i * 3;
+        for (unsigned threads : {1u, 4u}) {
+            check_equals_sort("lognormal", lognormal(n), threads);
+            check_equals_sort("few values", few_values(n), threads);
+            check_equals_sort("one dominant value", one_dominant_value(n), threads);
+            check_equals_sort("sorted", sorted, threads);
+        }
+    }
+    CHECK(percentiles({}, kPercentiles) == std::vector<double>(kPercentiles.size(), 0.0));
+}
+
+// Bands of continuous data are small enough to be selected in place;
+// bands made of long runs of equal values exceed the cap and are left to
+// the sequential selection instead of being copied.
+void bands_are_capped() {
+    auto targets_for = [](size_t n) {
+        std::vector<detail::SelectTarget> targets;
+        for (double p : kPercentiles) {
+            const double idx = p * (n - 1);
+            targets.push_back({static_cast<size_t>(std::floor(idx)), static_cast<size_t>(std::ceil(idx)), 0, 0, 0,
+                               0, false});
+        }
+        return targets;
+    };
+
+    const std::vector<uint64_t> continuous = lognormal(kLarge);
+    std::vector<detail::SelectTarget> targets = targets_for(kLarge);
+    detail::band_select(continuous, targets, 4);
+    std::vector<uint64_t> sorted = continuous;
+    std::sort(sorted.begin(), sorted.end());
+    for (const detail::SelectTarget &t : targets) {
+        CHECK(t.found);
+        if (!t.found) continue;
+        CHECK(t.v0 == sorted[t.r0]);
+        CHECK(t.v1 == sorted[t.r1]);
+    }
+
+    const std::vector<uint64_t> duplicates = few_values(kLarge);
+    targets = targets_for(kLarge);
+    detail::band_select(duplicates, targets, 4);
+    for (const detail::SelectTarget &t : targets) CHECK(!t.found);
+}
+
+}  // namespace
+
+int main() {
+    equals_full_sort();
+    bands_are_capped();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("percentiles: all checks passed");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file reorder_window_test.cpp
+ * @brief Regression tests for ReorderWindow
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "reorder_window.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+constexpr uint64_t kUs = 1000;
+
+RawMsg msg(uint64_t seq) {
+    RawMsg m{};
+    m.seq = seq;
+    return m;
+}
+
+// Delivering the gap's predecessors must restart the timeout from the oldest
+// message still held, not from one that was just delivered.
+void timeout_restarts_after_drain() {
+    ReorderWindow rw(64, 100 * kUs);
+    std::vector<uint64_t> out;
+    auto sink = [&](const RawMsg &m) { out.push_back(m.seq); };
+
+    rw.push(msg(1), 0, sink);
+    rw.push(msg(2), 0, sink);
+    rw.push(msg(5), 0, sink);         // held: 3 and 4 missing
+    rw.push(msg(8), 80 * kUs, sink);  // held: 6 and 7 missing
+    rw.push(msg(3), 90 * kUs, sink);
+    rw.push(msg(4), 90 * kUs, sink);  // delivers 4 and 5; 8 has waited 10us
+
+    rw.poll(100 * kUs, sink);         // 8 has waited 20us: keep waiting
+    CHECK(rw.stats().skipped == 0);
+    CHECK(rw.stats().timeouts == 0);
+    CHECK(rw.held_now() == 1);
+    CHECK((out == std::vector<uint64_t>{1, 2, 3, 4, 5}));
+
+    rw.poll(180 * kUs, sink);         // 8 has waited 100us: give up on 6 and 7
+    CHECK(rw.stats().skipped == 2);
+    CHECK(rw.stats().timeouts == 1);
+    CHECK(rw.held_now() == 0);
+    CHECK(out.back() == 8);
+}
+
+// A gap that nothing fills is skipped once the timeout has passed.
+void gap_skipped_after_timeout() {
+    ReorderWindow rw(64, 100 * kUs);
+    std::vector<uint64_t> out;
+    auto sink = [&](const RawMsg &m) { out.push_back(m.seq); };
+
+    rw.push(msg(1), 0, sink);
+    rw.push(msg(3), 10 * kUs, sink);
+    rw.poll(109 * kUs, sink);
+    CHECK(rw.stats().skipped == 0);
+    rw.poll(110 * kUs, sink);
+    CHECK(rw.stats().skipped == 1);
+    CHECK((out == std::vector<uint64_t>{1, 3}));
+}
+
+// After a partial drain the timeout restarts from the message held longest,
+// even when a lower sequence number arrived later.
+void timeout_follows_arrival_order() {
+    ReorderWindow rw(64, 100 * kUs);
+    std::vector<uint64_t> out;
+    auto sink = [&](const RawMsg &m) { out.push_back(m.seq); };
+
+    rw.push(msg(1), 0, sink);
+    rw.push(msg(20), 0, sink);         // held longest
+    rw.push(msg(5), 50 * kUs, sink);
+    rw.push(msg(12), 50 * kUs, sink);
+    rw.push(msg(2), 60 * kUs, sink);
+    rw.push(msg(3), 60 * kUs, sink);
+    rw.push(msg(4), 60 * kUs, sink);   // delivers 4 and 5; 12 and 20 stay held
+    CHECK(rw.held_now() == 2);
+
+    rw.poll(99 * kUs, sink);
+    CHECK(rw.stats().timeouts == 0);
+    rw.poll(100 * kUs, sink);          // 20 has waited 100us: give up on 6-11 and 13-19
+    CHECK(rw.stats().timeouts == 2);
+    CHECK(rw.stats().skipped == 13);
+    CHECK(rw.held_now() == 0);
+    CHECK((out == std::vector<uint64_t>{1, 2, 3, 4, 5, 12, 20}));
+}
+
+}  // namespace
+
+int main() {
+    timeout_restarts_after_drain();
+    gap_skipped_after_timeout();
+    timeout_follows_arrival_order();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("reorder_window: all checks passed");
+    return EXIT_SUCCESS;
+}
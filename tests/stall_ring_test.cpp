@@ -0,0 +1,129 @@
+/**
+ * @file stall_ring_test.cpp
+ * @brief Tests for StallRing's tagged slots
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+#include "outlier_tracker.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+// A recorded stall comes back with its send gap; messages without one
+// report nothing.
+void finds_recorded_stalls() {
+    StallRing ring(8);
+    ring.record(3, 5000, 1000);
+    ring.record(5, 700);
+    CHECK(ring.find(3).stall_ns == 5000);
+    CHECK(ring.find(3).gap_ns == 1000);
+    CHECK(ring.lookup(3) == 5000);
+    CHECK(ring.find(5).stall_ns == 700);
+    CHECK(ring.find(5).gap_ns == 0);
+    CHECK(ring.lookup(4) == 0);
+    CHECK(ring.find(4).gap_ns == 0);
+}
+
+// A later stall in the same slot replaces the earlier one: the earlier
+// message's lookup sees a different tag and reports no stall rather than
+// the later message's values.
+void rejects_overwritten_slots() {
+    StallRing ring(8);
+    ring.record(3, 5000, 1000);
+    ring.record(11, 9000, 2000);  // same slot: 11 & 7 == 3
+    CHECK(ring.lookup(3) == 0);
+    CHECK(ring.find(3).gap_ns == 0);
+    CHECK(ring.find(11).stall_ns == 9000);
+    CHECK(ring.find(11).gap_ns == 2000);
+    CHECK(ring.lookup(19) == 0);  // same slot, never recorded
+}
+
+// With a stride, a producer's consecutive sequence numbers use consecutive
+// slots, so a ring of N slots keeps its last N stalls; sequence numbers of
+// other producers that share a slot are rejected by the tag.
+void stride_spreads_a_producers_messages() {
+    constexpr uint64_t kStride = 4, kSize = 8;
+    StallRing ring(kSize, kStride);
+    for (uint64_t i = 0; i < kSize; ++i) ring.record(2 + i * kStride, 100 + i);
+    for (uint64_t i = 0; i < kSize; ++i) CHECK(ring.lookup(2 + i * kStride) == 100 + i);
+    CHECK(ring.lookup(3) == 0);  // another producer's message, slot of seq 2
+    ring.record(2 + kSize * kStride, 999);
+    CHECK(ring.lookup(2) == 0);
+    CHECK(ring.lookup(2 + kSize * kStride) == 999);
+    CHECK(ring.lookup(2 + kStride) == 101);
+}
+
+// A reader racing the writer never sees one message's tag with another
+// message's values.
+void concurrent_reads_are_consistent() {
+    constexpr uint64_t kMessages = 2'000'000;
+    StallRing ring(64);
+    std::atomic<uint64_t> written{0};
+    std::thread writer([&] {
+        for (uint64_t seq = 1; seq <= kMessages; ++seq) {
+            ring.record(seq, seq * 3, seq * 5);
+            written.store(seq, std::memory_order_release);
+        }
+    });
+    uint64_t found = 0, torn = 0;
+    for (uint64_t last = 0; last < kMessages;) {
+        last = written.load(std::memory_order_acquire);
+        for (uint64_t seq = last > 64 ? last - 64 : 1; seq <= last + 8; ++seq) {
+            const StallRing::Stall s = ring.find(seq);
+            if (!s.stall_ns) continue;
+            ++found;
+            torn += s.stall_ns != seq * 3 || s.gap_ns != seq * 5;
+        }
+    }
+    writer.join();
+    CHECK(found > 0);
+    CHECK(torn == 0);
+}
+
+void rejects_invalid_arguments() {
+    auto throws = [](auto make) {
+        try {
+            make();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws([] { StallRing(12); }));
+    CHECK(throws([] { StallRing(0); }));
+    CHECK(throws([] { StallRing(8, 0); }));
+}
+
+}  // namespace
+
+int main() {
+    finds_recorded_stalls();
+    rejects_overwritten_slots();
+    stride_spreads_a_producers_messages();
+    concurrent_reads_are_consistent();
+    rejects_invalid_arguments();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("stall_ring: all checks passed");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file symbol_sampler_test.cpp
+ * @brief Tests for SymbolSampler's alias table against the Zipf weights
+ *
+ * Exits with status 1 and names the failed check if any check fails. Checks
+ * do not use assert(), so they also run in release builds.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "symbol_sampler.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                      \
+        }                                                                    \
+    } while (0)
+
+constexpr double k2To32 = 4294967296.0;
+
+// Exact probability of every symbol id (index 0 unused). Each column owns
+// the draws whose high half maps to it; within the column, the low half
+// picks its own symbol below a threshold and its alias above it, which a
+// binary search over the low half locates.
+std::vector<double> exact_probabilities(const SymbolSampler &s) {
+    const uint64_t u = s.universe();
+    std::vector<double> prob(u + 1, 0.0);
+    for (uint64_t j = 0; j < u; ++j) {
+        const uint64_t hi_begin = (j * (uint64_t{1} << 32) + u - 1) / u;
+        const uint64_t hi_end = ((j + 1) * (uint64_t{1} << 32) + u - 1) / u;
+        const double width = (hi_end - hi_begin) / k2To32;
+        const uint64_t base = hi_begin << 32;
+        const uint32_t below = s(base), above = s(base | UINT32_MAX);
+        if (below == above) {
+            prob[below] += width;
+            continue;
+        }
+        uint64_t lo = 0, hi = UINT32_MAX;  // s(base | lo) == below, s(base | hi) == above
+        while (hi - lo > 1) {
+            const uint64_t mid = (lo + hi) / 2;
+            (s(base | mid) == below ? lo : hi) = mid;
+        }
+        prob[below] += width * hi / k2To32;
+        prob[above] += width * (k2To32 - hi) / k2To32;
+    }
+    return prob;
+}
+
+// Zipf weight of every rank of the slice first_rank, first_rank + stride, ...
+std::vector<double> zipf_weights(uint32_t universe, double skew, uint32_t first_rank, uint32_t stride) {
+    std::vector<double> w(universe);
+    for (uint32_t k = 0; k < universe; ++k) w[k] = std::pow(first_rank + static_cast<double>(k) * stride, -skew);
+    return w;
+}
+
+// Compares the sampler's per-symbol probabilities with the normalised Zipf
+// weights. The rank-to-id permutation is not visible, so both are compared
+// in descending order; every id must be drawn.
+void check_matches_weights(const SymbolSampler &s, uint32_t first_rank, uint32_t stride) {
+    std::vector<double> prob = exact_probabilities(s);
+    CHECK(prob[0] == 0.0);
+    prob.erase(prob.begin());
+    std::vector<double> want = zipf_weights(s.universe(), s.skew(), first_rank, stride);
+    double total = 0.0;
+    for (double w : want) total += w;
+    CHECK(std::fabs(total - s.mass()) <= 1e-9 * total);
+    for (double &w : want) w /= total;
+    std::sort(prob.begin(), prob.end(), std::greater<>());
+    std::sort(want.begin(), want.end(), std::greater<>());
+    CHECK(prob.back() > 0.0);
+    // Columns and thresholds are quantised to 2^-32 of the draw space.
+    const double tolerance = 4.0 * s.universe() / k2To32;
+    for (size_t i = 0; i < want.size(); ++i) {
+        if (std::fabs(prob[i] - want[i]) > tolerance * want[i] + 1e-12) {
+            std::fprintf(stderr, "universe %u skew %.2f ranks %u+%u: rank %zu drawn with p %.9g, Zipf %.9g\n",
+                         s.universe(), s.skew(), first_rank, stride, i + 1, prob[i], want[i]);
+            CHECK(std::fabs(prob[i] - want[i]) <= tolerance * want[i] + 1e-12);
+            return;
+        }
+    }
+}
+
+// Every symbol is drawn with exactly its Zipf share, for uniform, moderate
+// and steep skews and for universes that do not divide 2^32.
+void alias_table_matches_zipf_weights() {
+    for (uint32_t universe : {1u, 7u, 1000u, 100'000u}) {
+        for (double skew : {0.0, 0.8, 1.0, 2.5}) {
+            check_matches_weights(SymbolSampler(universe, skew), 1, 1);
+        }
+    }
+}
+
+// Rank slices draw from their own ranks' weights, and their masses add up
+// to the whole universe's.
+void slices_partition_the_universe() {
+    constexpr uint32_t kUniverse = 4000, kSlices = 4;
+    const SymbolSampler whole(kUniverse, 1.0);
+    double mass = 0.0;
+    for (uint32_t i = 0; i < kSlices; ++i) {
+        const SymbolSampler slice(kUniverse / kSlices, 1.0, 1, 1 + i, kSlices);
+        check_matches_weights(slice, 1 + i, kSlices);
+        mass += slice.mass();
+    }
+    CHECK(std::fabs(mass - whole.mass()) <= 1e-9 * mass);
+}
+
+// Draws from uniformly random bits land on the most popular symbols at the
+// rate top_share() predicts.
+void draws_follow_top_share() {
+    const SymbolSampler s(1000, 1.0);
+    std::vector<double> prob = exact_probabilities(s);
+    std::vector<uint32_t> by_popularity(s.universe());
+    for (uint32_t id = 1; id <= s.universe(); ++id) by_popularity[id - 1] = id;
+    std::sort(by_popularity.begin(), by_popularity.end(), [&](uint32_t a, uint32_t b) { return prob[a] > prob[b]; });
+    std::vector<char> top10(s.universe() + 1, 0);
+    for (size_t i = 0; i < 10; ++i) top10[by_popularity[i]] = 1;
+
+    constexpr size_t kDraws = 2'000'000;
+    std::mt19937_64 rng(7);
+    size_t hits = 0;
+    for (size_t i = 0; i < kDraws; ++i) hits += top10[s(rng())];
+    const double p = s.top_share(10);
+    const double sigma = std::sqrt(kDraws * p * (1.0 - p));
+    CHECK(std::fabs(hits - kDraws * p) <= 5.0 * sigma);
+    CHECK(std::fabs(s.top_share(s.universe()) - 1.0) <= 1e-12);
+}
+
+void rejects_invalid_arguments() {
+    auto throws = [](auto make) {
+        try {
+            make();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws([] { SymbolSampler(0, 1.0); }));
+    CHECK(throws([] { SymbolSampler(SymbolSampler::kMaxUniverse + 1, 1.0); }));
+    CHECK(throws([] { SymbolSampler(10, -0.5); }));
+    CHECK(throws([] { SymbolSampler(10, 1.0, 1, 0, 1); }));
+    CHECK(throws([] { SymbolSampler(10, 1.0, 1, 1, 0); }));
+}
+
+}  // namespace
+
+int main() {
+    alias_table_matches_zipf_weights();
+    slices_partition_the_universe();
+    draws_follow_top_share();
+    rejects_invalid_arguments();
+    if (failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("symbol_sampler: all checks passed");
+    return EXIT_SUCCESS;
+}
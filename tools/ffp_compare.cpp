@@ -0,0 +1,262 @@
+/**
+ * @file ffp_compare.cpp
+ * @brief Run-to-run regression check for fast-feed-parser JSON reports
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Compares candidate runs against baseline runs, each a report written with
+ * `fast-feed-parser --json=...` (for example the per-run reports of
+ * ffp-harness). Whole runs differ by 10-30% between invocations, and the
+ * intervals of one run share its luck and are autocorrelated, so each side
+ * needs several independent runs: the unit of comparison is the run.
+ * Throughput and the p99 and p99.9 of each run's merged latency histogram
+ * are compared across runs with Welch's t-test; a metric regresses when it
+ * moved in the bad direction by more than the threshold and the change is
+ * significant at the chosen level. Differences in configuration or host are
+ * printed as warnings, since they usually explain a difference on their own.
+ *
+ * Command line arguments:
+ *   ./ffp-compare BASELINE.json... --vs CANDIDATE.json... [--alpha=A] [--threshold=PCT]
+ *
+ * Each side needs at least 3 reports.
+ *
+ * Exit status: 0 no regression, 1 regression found, 2 usage or input error.
+ */
+
+#include "json_value.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    double alpha = 0.01;      ///< Significance level
+    double threshold = 0.05;  ///< Smallest relative change treated as a regression
+};
+
+struct Metric {
+    const char *name;
+    const char *key;  ///< Member of summary or summary.latency_ns (run-long histogram)
+    bool higher_is_better;
+};
+
+const Metric kMetrics[] = {
+    {"throughput (msgs/s)", "throughput_msgs_per_s", true},
+    {"p99 latency (ns)", "p99", false},
+    {"p99.9 latency (ns)", "p999", false},
+};
+
+// Fewest runs per side: Welch's test needs a variance, and two runs say
+// little about one
+constexpr size_t kMinReports = 3;
+
+JsonValue load(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    JsonValue v = JsonValue::parse(ss.str());
+    if (!v.has("version") || !v.has("summary")) throw std::runtime_error(path + " is not a benchmark report");
+    return v;
+}
+
+// Whole-run value of one report, or NaN if the report lacks it (no HDR recorder)
+double metric_value(const JsonValue &report, const Metric &m) {
+    const JsonValue &s = report["summary"];
+    if (s.has(m.key)) return s[m.key].number();
+    if (s.has("latency_ns") && s["latency_ns"].has(m.key)) return s["latency_ns"][m.key].number();
+    return std::nan("");
+}
+
+// Continued fraction for the incomplete beta function (Numerical Recipes betacf)
+double beta_cf(double a, double b, double x) {
+    const double tiny = 1e-300;
+    double qab = a + b, qap = a + 1.0, qam = a - 1.0;
+    double c = 1.0, d = 1.0 - qab * x / qap;
+    if (std::abs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= 300; ++m) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+        if (std::abs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+        if (std::abs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double del = d * c;
+        h *= del;
+        if (std::abs(del - 1.0) < 1e-12) break;
+    }
+    return h;
+}
+
+// Regularized incomplete beta I_x(a, b)
+double incomplete_beta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double bt = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) +
+                         b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0)) return bt * beta_cf(a, b, x) / a;
+    return 1.0 - bt * beta_cf(b, a, 1.0 - x) / b;
+}
+
+struct Welch {
+    double mean_a = 0.0, mean_b = 0.0;
+    double p = 1.0;  ///< Two-sided p-value of equal means
+};
+
+/**
+ * @brief Welch's unequal-variance t-test
+ */
+Welch welch_test(const std::vector<double> &a, const std::vector<double> &b) {
+    auto stats = [](const std::vector<double> &v, double &mean, double &var) {
+        mean = 0.0;
+        for (double x : v) mean += x;
+        mean /= v.size();
+        var = 0.0;
+        for (double x : v) var += (x - mean) * (x - mean);
+        var = v.size() > 1 ? var / (v.size() - 1) : 0.0;
+    };
+    Welch w;
+    double va, vb;
+    stats(a, w.mean_a, va);
+    stats(b, w.mean_b, vb);
+    double sa = va / a.size(), sb = vb / b.size();
+    double se = std::sqrt(sa + sb);
+    if (se <= 0.0) {
+        w.p = w.mean_a == w.mean_b ? 1.0 : 0.0;
+        return w;
+    }
+    double t = (w.mean_b - w.mean_a) / se;
+    double df = (sa + sb) * (sa + sb) /
+                ((sa * sa) / std::max<size_t>(a.size() - 1, 1) + (sb * sb) / std::max<size_t>(b.size() - 1, 1));
+    w.p = incomplete_beta(df / 2.0, 0.5, df / (df + t * t));
+    return w;
+}
+
+// One value per run, or empty if any report lacks the metric
+std::vector<double> run_values(const std::vector<JsonValue> &reports, const Metric &m) {
+    std::vector<double> out;
+    for (const JsonValue &r : reports) {
+        const double v = metric_value(r, m);
+        if (std::isnan(v)) return {};
+        out.push_back(v);
+    }
+    return out;
+}
+
+void warn_differences(const JsonValue &a, const JsonValue &b, const char *section, const std::string &what) {
+    for (const auto &[key, va] : a[section].members()) {
+        std::string vb = b[section].has(key) ? b[section][key].str() : "(missing)";
+        if (va.str() != vb) {
+            std::cout << "[WARN] " << what << ": " << section << "." << key << " differs: " << va.str() << " vs "
+                      << vb << "\n";
+        }
+    }
+}
+
+bool parse_flag(const std::string &arg, const char *name, double &out) {
+    std::string prefix = std::string(name) + "=";
+    if (arg.rfind(prefix, 0) != 0) return false;
+    out = std::stod(arg.substr(prefix.size()));
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    std::vector<std::string> files[2];  // baseline, candidate
+    try {
+        size_t side = 0;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            double v = 0.0;
+            if (parse_flag(arg, "--alpha", v)) {
+                opt.alpha = v;
+            } else if (parse_flag(arg, "--threshold", v)) {
+                opt.threshold = v / 100.0;
+            } else if (arg == "--vs" && side == 0) {
+                side = 1;
+            } else if (arg.rfind("--", 0) == 0) {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                files[side].push_back(arg);
+            }
+        }
+        if (side == 0) throw std::invalid_argument("expected baseline reports, --vs and candidate reports");
+        if (files[0].size() < kMinReports || files[1].size() < kMinReports) {
+            throw std::invalid_argument("need at least " + std::to_string(kMinReports) +
+                                        " reports per side (independent runs, e.g. from ffp-harness)");
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n"
+                  << "Usage: " << argv[0]
+                  << " BASELINE.json... --vs CANDIDATE.json... [--alpha=0.01] [--threshold=5]\n";
+        return 2;
+    }
+
+    try {
+        std::vector<JsonValue> base, cand;
+        for (const std::string &f : files[0]) base.push_back(load(f));
+        for (const std::string &f : files[1]) cand.push_back(load(f));
+        for (size_t i = 1; i < base.size(); ++i) warn_differences(base[0], base[i], "config", files[0][i]);
+        for (size_t i = 1; i < cand.size(); ++i) warn_differences(cand[0], cand[i], "config", files[1][i]);
+        warn_differences(base[0], cand[0], "config", "baseline vs candidate");
+        warn_differences(base[0], cand[0], "host", "baseline vs candidate");
+
+        std::cout << base.size() << " baseline and " << cand.size() << " candidate runs, means of whole-run values\n";
+        std::cout << std::left << std::setw(22) << "metric" << std::right << std::setw(14) << "baseline"
+                  << std::setw(14) << "candidate" << std::setw(10) << "change" << std::setw(10) << "p-value"
+                  << "  verdict\n";
+        bool regression = false;
+        for (const Metric &m : kMetrics) {
+            std::vector<double> a = run_values(base, m);
+            std::vector<double> b = run_values(cand, m);
+            std::cout << std::left << std::setw(22) << m.name << std::right;
+            if (a.empty() || b.empty()) {
+                std::cout << "  (not in every report; latency needs the HDR recorder)\n";
+                continue;
+            }
+            Welch w = welch_test(a, b);
+            double change = w.mean_a != 0.0 ? (w.mean_b - w.mean_a) / w.mean_a : 0.0;
+            double worse = m.higher_is_better ? -change : change;
+            bool significant = w.p < opt.alpha;
+            const char *verdict = "ok";
+            if (significant && worse > opt.threshold) {
+                verdict = "REGRESSION";
+                regression = true;
+            } else if (significant && -worse > opt.threshold) {
+                verdict = "improved";
+            }
+            std::cout << std::fixed << std::setprecision(0) << std::setw(14) << w.mean_a << std::setw(14)
+                      << w.mean_b << std::setprecision(1) << std::setw(9) << (change * 100.0) << "%"
+                      << std::setprecision(4) << std::setw(10) << w.p << "  " << verdict << "\n";
+        }
+        std::cout << std::defaultfloat << std::setprecision(6) << "\n"
+                  << (regression ? "Regression detected" : "No significant regression") << " (alpha "
+                  << opt.alpha << ", threshold " << opt.threshold * 100.0 << "%)\n";
+        return regression ? 1 : 0;
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        return 2;
+    }
+}
@@ -0,0 +1,356 @@
+/**
+ * @file ffp_harness.cpp
+ * @brief Repeated-run benchmark harness with bootstrap confidence intervals
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * One run of fast-feed-parser varies by 10-30% between invocations (CPU
+ * frequency, page placement, scheduling), so a single run cannot separate a
+ * change from noise. The harness runs every configuration K times after W
+ * discarded warm-up runs, shuffling the order of the configurations in each
+ * round so that slow drift of the machine is spread evenly over them. From
+ * the --json reports it prints, per configuration, the median throughput
+ * and latency percentiles with 95% bootstrap confidence intervals, and for
+ * further configurations the ratio of medians to the first one with its own
+ * interval. A configuration whose coefficient of variation exceeds the limit
+ * is flagged as too noisy to trust, and single runs far from the median
+ * (more than 3 median absolute deviations and more than 1% off) are listed.
+ *
+ * Command line arguments:
+ *   ./ffp-harness [--runs=K] [--warmup=W] [--seed=S] [--cv=PCT] [--binary=PATH] [--out=DIR]
+ *                 "ARGS" ["ARGS" ...]
+ *
+ * Each ARGS string is one configuration: the arguments passed to the
+ * benchmark, e.g. "500000 5 16" or "500000 5 16 --shards=2".
+ *
+ * Exit status: 0 success, 1 a configuration is too noisy, 2 usage, run or
+ * input error.
+ */
+
+#include "json_value.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+    size_t runs = 10;                 ///< Measured runs per configuration
+    size_t warmup = 1;                ///< Discarded runs per configuration
+    uint64_t seed = 1;                ///< Run order and bootstrap resampling
+    double cv_limit = 0.10;           ///< Coefficient of variation above which results are flagged
+    std::string binary;               ///< Benchmark executable
+    std::string out = "ffp-harness";  ///< Directory for the per-run reports
+};
+
+struct Config {
+    std::string label;
+    std::vector<std::string> args;
+    std::vector<std::vector<double>> values;  ///< Per metric, one value per measured run
+};
+
+struct Metric {
+    const char *name;
+    const char *key;  ///< Member of summary or summary.latency_ns
+};
+
+// Throughput first. The maximum is left out: one sample per run is noise by nature
+const Metric kMetrics[] = {
+    {"throughput (msgs/s)", "throughput_msgs_per_s"},
+    {"p50 (ns)", "p50"},
+    {"p90 (ns)", "p90"},
+    {"p99 (ns)", "p99"},
+    {"p99.9 (ns)", "p999"},
+    {"p99.99 (ns)", "p9999"},
+};
+constexpr size_t kMetricCount = sizeof(kMetrics) / sizeof(kMetrics[0]);
+
+constexpr size_t kResamples = 2000;
+
+// A run is an outlier only if it is more than kOutlierMads MADs and more than
+// kOutlierMinDeviation of the median away: with a few tight runs the MAD is
+// tiny, and a 0.01% difference would otherwise count as many MADs
+constexpr double kOutlierMads = 3.0;
+constexpr double kOutlierMinDeviation = 0.01;
+
+// Width of the "vs config 1 (ci)" column, e.g. "325.796 (304.056-335.222)"
+constexpr int kRatioWidth = 30;
+
+bool parse_flag(const std::string &arg, const char *name, std::string &out) {
+    std::string prefix = std::string(name) + "=";
+    if (arg.rfind(prefix, 0) != 0) return false;
+    out = arg.substr(prefix.size());
+    return true;
+}
+
+// The benchmark next to build/tools/, or the one on PATH
+std::string default_binary(const char *argv0) {
+    namespace fs = std::filesystem;
+    fs::path sibling = fs::path(argv0).parent_path() / ".." / "fast-feed-parser";
+    std::error_code ec;
+    return fs::exists(sibling, ec) ? sibling.string() : "fast-feed-parser";
+}
+
+/**
+ * @brief Runs the benchmark once with its console output discarded
+ *
+ * @throws std::runtime_error if it cannot be started or exits with an error
+ */
+void run_once(const std::string &binary, const std::vector<std::string> &args) {
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(binary.c_str()));
+    for (const std::string &a : args) argv.push_back(const_cast<char *>(a.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0) throw std::runtime_error("fork failed");
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+            close(devnull);
+        }
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) throw std::runtime_error("waitpid failed");
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error(binary + " failed (status " +
+                                 std::to_string(WIFEXITED(status) ? WEXITSTATUS(status) : -1) + ")");
+    }
+}
+
+JsonValue load(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    JsonValue v = JsonValue::parse(ss.str());
+    if (!v.has("version") || !v.has("summary")) throw std::runtime_error(path + " is not a benchmark report");
+    return v;
+}
+
+// Metric value of one report, or NaN if the report lacks it (no HDR recorder)
+double metric_value(const JsonValue &report, const Metric &m) {
+    const JsonValue &s = report["summary"];
+    if (s.has(m.key)) return s[m.key].number();
+    if (s.has("latency_ns") && s["latency_ns"].has(m.key)) return s["latency_ns"][m.key].number();
+    return std::nan("");
+}
+
+double median(std::vector<double> v) {
+    const size_t n = v.size();
+    std::nth_element(v.begin(), v.begin() + n / 2, v.end());
+    double hi = v[n / 2];
+    if (n % 2) return hi;
+    return (*std::max_element(v.begin(), v.begin() + n / 2) + hi) / 2.0;
+}
+
+double coefficient_of_variation(const std::vector<double> &v) {
+    double mean = 0.0;
+    for (double x : v) mean += x;
+    mean /= v.size();
+    double var = 0.0;
+    for (double x : v) var += (x - mean) * (x - mean);
+    var = v.size() > 1 ? var / (v.size() - 1) : 0.0;
+    return mean != 0.0 ? std::sqrt(var) / std::abs(mean) : 0.0;
+}
+
+struct Interval {
+    double lo = 0.0, hi = 0.0;
+};
+
+// 2.5% and 97.5% points of bootstrap statistics
+Interval percentile_interval(std::vector<double> &stats) {
+    std::sort(stats.begin(), stats.end());
+    auto at = [&](double q) { return stats[static_cast<size_t>(q * (stats.size() - 1))]; };
+    return {at(0.025), at(0.975)};
+}
+
+std::vector<double> resample(const std::vector<double> &v, std::mt19937_64 &rng) {
+    std::uniform_int_distribution<size_t> pick(0, v.size() - 1);
+    std::vector<double> out(v.size());
+    for (double &x : out) x = v[pick(rng)];
+    return out;
+}
+
+/**
+ * @brief Percentile bootstrap interval of the median
+ */
+Interval bootstrap_median(const std::vector<double> &v, std::mt19937_64 &rng) {
+    std::vector<double> stats(kResamples);
+    for (double &s : stats) s = median(resample(v, rng));
+    return percentile_interval(stats);
+}
+
+/**
+ * @brief Percentile bootstrap interval of median(b) / median(a)
+ */
+Interval bootstrap_ratio(const std::vector<double> &a, const std::vector<double> &b, std::mt19937_64 &rng) {
+    std::vector<double> stats(kResamples);
+    for (double &s : stats) {
+        double ma = median(resample(a, rng));
+        s = ma != 0.0 ? median(resample(b, rng)) / ma : 0.0;
+    }
+    return percentile_interval(stats);
+}
+
+std::vector<std::string> split(const std::string &s) {
+    std::istringstream is(s);
+    std::vector<std::string> out;
+    for (std::string w; is >> w;) out.push_back(w);
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    std::vector<Config> configs;
+    try {
+        opt.binary = default_binary(argv[0]);
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::string v;
+            if (parse_flag(arg, "--runs", v)) {
+                opt.runs = std::stoul(v);
+            } else if (parse_flag(arg, "--warmup", v)) {
+                opt.warmup = std::stoul(v);
+            } else if (parse_flag(arg, "--seed", v)) {
+                opt.seed = std::stoull(v);
+            } else if (parse_flag(arg, "--cv", v)) {
+                opt.cv_limit = std::stod(v) / 100.0;
+            } else if (parse_flag(arg, "--binary", v)) {
+                opt.binary = v;
+            } else if (parse_flag(arg, "--out", v)) {
+                opt.out = v;
+            } else if (arg.rfind("--", 0) == 0) {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                Config c;
+                c.label = arg;
+                c.args = split(arg);
+                c.values.resize(kMetricCount);
+                configs.push_back(std::move(c));
+            }
+        }
+        if (configs.empty()) throw std::invalid_argument("expected at least one configuration");
+        if (opt.runs < 3) throw std::invalid_argument("--runs must be at least 3");
+        for (const Config &c : configs) {
+            for (const std::string &a : c.args) {
+                if (a.rfind("--json", 0) == 0) throw std::invalid_argument("configurations must not set --json");
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n"
+                  << "Usage: " << argv[0]
+                  << " [--runs=10] [--warmup=1] [--seed=1] [--cv=10] [--binary=PATH] [--out=DIR]"
+                     " \"ARGS\" [\"ARGS\" ...]\n";
+        return 2;
+    }
+
+    std::mt19937_64 rng(opt.seed);
+    try {
+        std::filesystem::create_directories(opt.out);
+
+        // Rounds of every configuration in a fresh random order; warm-up rounds first
+        const size_t rounds = opt.warmup + opt.runs;
+        const size_t total = rounds * configs.size();
+        std::vector<size_t> order(configs.size());
+        size_t done = 0;
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::shuffle(order.begin(), order.end(), rng);
+            const bool warm = round < opt.warmup;
+            for (size_t ci : order) {
+                Config &c = configs[ci];
+                std::string path = opt.out + "/config" + std::to_string(ci + 1) + "-" +
+                                   (warm ? "warmup" + std::to_string(round + 1)
+                                         : "run" + std::to_string(round - opt.warmup + 1)) + ".json";
+                std::vector<std::string> args = c.args;
+                args.push_back("--json=" + path);
+                std::cerr << "[run " << ++done << "/" << total << "] " << (warm ? "warm-up " : "")
+                          << "config " << ci + 1 << ": " << c.label << "\n";
+                run_once(opt.binary, args);
+                if (warm) continue;
+                JsonValue report = load(path);
+                for (size_t m = 0; m < kMetricCount; ++m) c.values[m].push_back(metric_value(report, kMetrics[m]));
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        return 2;
+    }
+
+    bool noisy = false;
+    std::cout << "\n" << opt.runs << " runs per configuration after " << opt.warmup
+              << " warm-up, medians with 95% bootstrap intervals; reports in " << opt.out << "/\n";
+    for (size_t ci = 0; ci < configs.size(); ++ci) {
+        const Config &c = configs[ci];
+        std::cout << "\nconfig " << ci + 1 << ": " << c.label << "\n";
+        std::cout << std::left << std::setw(22) << "metric" << std::right << std::setw(14) << "median"
+                  << std::setw(14) << "ci low" << std::setw(14) << "ci high" << std::setw(9) << "cv";
+        if (ci > 0) std::cout << "  " << std::setw(kRatioWidth) << "vs config 1 (ci)";
+        std::cout << "  verdict\n";
+        for (size_t m = 0; m < kMetricCount; ++m) {
+            const std::vector<double> &v = c.values[m];
+            if (std::any_of(v.begin(), v.end(), [](double x) { return std::isnan(x); })) continue;
+            const double med = median(v);
+            const Interval ci_med = bootstrap_median(v, rng);
+            const double cv = coefficient_of_variation(v);
+            const bool unstable = cv > opt.cv_limit;
+            noisy |= unstable;
+            std::cout << std::left << std::setw(22) << kMetrics[m].name << std::right << std::fixed
+                      << std::setprecision(0) << std::setw(14) << med << std::setw(14) << ci_med.lo << std::setw(14)
+                      << ci_med.hi << std::setprecision(1) << std::setw(8) << cv * 100.0 << "%";
+            if (ci > 0) {
+                const std::vector<double> &base = configs[0].values[m];
+                const double ratio = median(base) != 0.0 ? med / median(base) : 0.0;
+                const Interval ci_ratio = bootstrap_ratio(base, v, rng);
+                std::ostringstream cell;
+                cell << std::fixed << std::setprecision(3) << ratio << " (" << ci_ratio.lo << "-" << ci_ratio.hi
+                     << ")";
+                std::cout << "  " << std::setw(kRatioWidth) << cell.str();
+                std::cout << "  " << (unstable ? "TOO NOISY"
+                                      : ci_ratio.lo > 1.0 || ci_ratio.hi < 1.0 ? "differs" : "same");
+            } else {
+                std::cout << "  " << (unstable ? "TOO NOISY" : "ok");
+            }
+            std::cout << "\n";
+        }
+
+        // Single runs far from the rest, judged on throughput
+        const std::vector<double> &tp = c.values[0];
+        const double med = median(tp);
+        std::vector<double> dev(tp.size());
+        for (size_t i = 0; i < tp.size(); ++i) dev[i] = std::abs(tp[i] - med);
+        const double mad = median(dev);
+        for (size_t i = 0; i < tp.size(); ++i) {
+            if (mad > 0.0 && dev[i] > kOutlierMads * mad && dev[i] > kOutlierMinDeviation * med) {
+                std::cout << "  [WARN] run " << i + 1 << " throughput " << std::setprecision(0) << tp[i]
+                          << " msgs/s is " << std::setprecision(1) << dev[i] / mad << " MADs from the median\n";
+            }
+        }
+    }
+    std::cout << std::defaultfloat << std::setprecision(6) << "\n"
+              << (noisy ? "Some results exceed the variation limit (" : "All results within the variation limit (")
+              << opt.cv_limit * 100.0 << "% cv)\n";
+    return noisy ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ffp_stat.cpp
+ * @brief Live monitor for a running fast-feed-parser
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Attaches read-only to the shared-memory metrics region published by
+ * `fast-feed-parser --shm` and prints one line per interval: produced and
+ * consumed rates, queue depth and latency percentiles of the interval. The
+ * benchmark's threads are never signalled or blocked.
+ *
+ * Command line arguments:
+ *   ./ffp-stat [name] [interval_ms] [count]
+ *
+ * Example:
+ *   ./fast-feed-parser 1000000 60 17 --shm &
+ *   ./ffp-stat /ffp-metrics 500
+ */
+
+#include "shm_metrics.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+using Buckets = std::array<uint64_t, kMetricsLatencyBuckets>;
+
+void snapshot(const MetricsRegion &r, Buckets &out) {
+    for (size_t i = 0; i < out.size(); ++i) out[i] = r.latency[i].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Upper bound of the bucket holding quantile @p q of the interval counts
+ */
+uint64_t quantile(const Buckets &cur, const Buckets &prev, uint64_t total, double q) {
+    if (total == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < cur.size(); ++i) {
+        seen += cur[i] - prev[i];
+        if (seen >= target) {
+            return i + 1 < cur.size() ? MetricsRegion::bucket_lower(i + 1) - 1 : UINT64_MAX;
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string name = argc >= 2 ? argv[1] : kMetricsDefaultName;
+    auto interval = std::chrono::milliseconds(argc >= 3 ? std::stoul(argv[2]) : 1000);
+    uint64_t count = argc >= 4 ? std::stoull(argv[3]) : 0;  // 0 = until the run ends
+
+    try {
+        SharedMetrics shm(name, SharedMetrics::Mode::Attach);
+        const MetricsRegion &r = shm.region();
+        std::cout << "Attached to " << name << " (pid " << r.pid << ", layout v" << r.version
+                  << "), target " << r.target_rate.load(std::memory_order_relaxed) << " msgs/s, queue "
+                  << r.queue_capacity.load(std::memory_order_relaxed) << "\n";
+        std::cout << "Percentiles are bucket upper bounds (within 12.5%)\n\n";
+        std::cout << std::setw(12) << "prod/s" << std::setw(12) << "cons/s" << std::setw(10) << "depth"
+                  << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+                  << std::setw(10) << "max" << " μs\n";
+
+        Buckets prev{}, cur{};
+        snapshot(r, prev);
+        uint64_t prev_prod = r.produced.load(std::memory_order_relaxed);
+        uint64_t prev_cons = r.consumed.load(std::memory_order_relaxed);
+        auto prev_t = std::chrono::steady_clock::now();
+
+        for (uint64_t n = 0; count == 0 || n < count; ++n) {
+            std::this_thread::sleep_for(interval);
+            auto t = std::chrono::steady_clock::now();
+            snapshot(r, cur);
+            uint64_t prod = r.produced.load(std::memory_order_relaxed);
+            uint64_t cons = r.consumed.load(std::memory_order_relaxed);
+            double secs = std::chrono::duration<double>(t - prev_t).count();
+
+            uint64_t total = 0;
+            for (size_t i = 0; i < cur.size(); ++i) total += cur[i] - prev[i];
+            auto us = [](uint64_t ns) { return ns / 1000.0; };
+            std::cout << std::fixed << std::setprecision(2) << std::setw(12)
+                      << static_cast<uint64_t>((prod - prev_prod) / secs) << std::setw(12)
+                      << static_cast<uint64_t>((cons - prev_cons) / secs) << std::setw(10)
+                      << r.queue_depth.load(std::memory_order_relaxed) << std::setw(10)
+                      << us(quantile(cur, prev, total, 0.50)) << std::setw(10)
+                      << us(quantile(cur, prev, total, 0.99)) << std::setw(10)
+                      << us(quantile(cur, prev, total, 0.999)) << std::setw(10)
+                      << us(r.latency_max_ns.load(std::memory_order_relaxed)) << "\n";
+
+            prev = cur;
+            prev_prod = prod;
+            prev_cons = cons;
+            prev_t = t;
+            if (r.running.load(std::memory_order_relaxed) == 0) {
+                std::cout << "Benchmark finished\n";
+                break;
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
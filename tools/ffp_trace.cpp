@@ -0,0 +1,133 @@
+/**
+ * @file ffp_trace.cpp
+ * @brief Timeline decoder for fast-feed-parser flight recorder dumps
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Reads a dump written by `fast-feed-parser --flight` and prints what fired
+ * it, how many events each thread kept, and the events of all threads merged
+ * into one timeline, with times relative to the trigger. Runs of pops are
+ * shown as they were recorded; use --last to see only the moments before and
+ * around the anomaly.
+ *
+ * Command line arguments:
+ *   ./ffp-trace dump.bin [--last=N] [--thread=NAME]
+ *
+ * Exit status: 0 success, 2 usage or input error.
+ */
+
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string path;
+    size_t last = 0;     ///< Events printed (0 = all)
+    std::string thread;  ///< Only this thread's events (empty = all)
+};
+
+Options parse_args(int argc, char **argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--last=", 0) == 0) {
+            opt.last = std::stoull(arg.substr(7));
+        } else if (arg.rfind("--thread=", 0) == 0) {
+            opt.thread = arg.substr(9);
+        } else if (arg.rfind("--", 0) == 0) {
+            throw std::invalid_argument("unknown option " + arg);
+        } else if (opt.path.empty()) {
+            opt.path = arg;
+        } else {
+            throw std::invalid_argument("expected one dump file");
+        }
+    }
+    if (opt.path.empty()) throw std::invalid_argument("expected one dump file");
+    return opt;
+}
+
+// Signed microseconds from the trigger
+double rel_us(uint64_t t, uint64_t origin) {
+    return t >= origin ? (t - origin) / 1000.0 : -((origin - t) / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    try {
+        opt = parse_args(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n"
+                  << "Usage: " << argv[0] << " dump.bin [--last=N] [--thread=NAME]\n";
+        return 2;
+    }
+
+    FlightDump d;
+    try {
+        d = read_flight_dump(opt.path);
+    } catch (const std::exception &e) {
+        std::cerr << "[ERROR] " << e.what() << "\n";
+        return 2;
+    }
+
+    const FlightDumpHeader &h = d.header;
+    std::cout << "Trigger: " << flight_trigger_name(h.trigger);
+    if (h.trigger_seq) std::cout << " at seq " << h.trigger_seq;
+    if (h.trigger == static_cast<uint32_t>(FlightTrigger::Latency)) {
+        std::cout << ", latency " << std::fixed << std::setprecision(2) << h.trigger_value / 1000.0 << " μs";
+    } else if (h.trigger == static_cast<uint32_t>(FlightTrigger::Gap)) {
+        std::cout << ", " << h.trigger_value << " sequences missing";
+    }
+    std::cout << "\n\n" << std::left << std::setw(14) << "thread" << std::right << std::setw(12) << "events"
+              << std::setw(14) << "overwritten" << "\n";
+    for (const FlightThreadHeader &t : d.threads) {
+        std::cout << std::left << std::setw(14) << t.name << std::right << std::setw(12) << t.record_count
+                  << std::setw(14) << t.dropped << "\n";
+    }
+
+    // Merge the rings into one timeline
+    std::vector<FlightRecord> events;
+    events.reserve(d.records.size());
+    for (const FlightRecord &r : d.records) {
+        if (r.thread >= d.threads.size()) continue;
+        if (!opt.thread.empty() && opt.thread != d.threads[r.thread].name) continue;
+        events.push_back(r);
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const FlightRecord &a, const FlightRecord &b) { return a.t_ns < b.t_ns; });
+    if (opt.last && events.size() > opt.last) {
+        events.erase(events.begin(), events.end() - static_cast<std::ptrdiff_t>(opt.last));
+    }
+
+    std::cout << "\n" << std::right << std::setw(13) << "t (μs)" << "  " << std::left << std::setw(12) << "thread"
+              << std::setw(13) << "event" << std::right << std::setw(12) << "seq" << std::setw(12) << "arg" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    bool marked = false;
+    for (const FlightRecord &r : events) {
+        if (!marked && r.t_ns > h.trigger_t_ns) {
+            std::cout << std::setw(12) << 0.0 << "  <<< trigger\n";
+            marked = true;
+        }
+        std::cout << std::right << std::setw(12) << rel_us(r.t_ns, h.trigger_t_ns) << "  " << std::left
+                  << std::setw(12) << d.threads[r.thread].name << std::setw(13) << flight_event_name(r.event)
+                  << std::right << std::setw(12);
+        if (r.seq) {
+            std::cout << r.seq;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::setw(12) << r.arg << "\n";
+    }
+    if (!marked) std::cout << std::setw(12) << 0.0 << "  <<< trigger\n";
+    return 0;
+}
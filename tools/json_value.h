@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cctype>
+#include <cstdlib>
+#include <initializer_list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file json_value.h
+ * @brief Minimal JSON reader for the report tools
+ * @author Imtiaz Qureshi (Enterprise Solutions Team)
+ * @version 1.0.0
+ * @date 2025
+ *
+ * Parses the reports written by fast-feed-parser --json into a small value
+ * tree. Supports the full JSON grammar except \u escapes outside the ASCII
+ * range, which the reports never contain.
+ */
+
+/**
+ * @class JsonValue
+ * @brief A parsed JSON value (null, bool, number, string, array or object)
+ */
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    /**
+     * @brief Parses a complete JSON document
+     *
+     * @throws std::runtime_error on malformed input
+     */
+    static JsonValue parse(const std::string &text) {
+        size_t pos = 0;
+        JsonValue v = parse_value(text, pos);
+        skip_ws(text, pos);
+        if (pos != text.size()) throw std::runtime_error("trailing characters after JSON value");
+        return v;
+    }
+
+    Type type() const noexcept { return type_; }
+    bool is_number() const noexcept { return type_ == Type::Number; }
+    bool is_array() const noexcept { return type_ == Type::Array; }
+    bool is_object() const noexcept { return type_ == Type::Object; }
+
+    /// @brief Numeric value
+    /// @throws std::runtime_error if this is not a number
+    double number() const {
+        if (type_ != Type::Number) throw std::runtime_error("JSON value is not a number");
+        return number_;
+    }
+
+    /// @brief String value (numbers and booleans are returned as their text)
+    const std::string &str() const noexcept { return string_; }
+
+    /// @brief Array elements (empty for non-arrays)
+    const std::vector<JsonValue> &items() const noexcept { return items_; }
+
+    /// @brief True if this object has member @p key
+    bool has(const std::string &key) const {
+        return type_ == Type::Object && members_.count(key) != 0;
+    }
+
+    /// @brief Object member @p key
+    /// @throws std::runtime_error if missing
+    const JsonValue &operator[](const std::string &key) const {
+        auto it = members_.find(key);
+        if (type_ != Type::Object || it == members_.end()) {
+            throw std::runtime_error("JSON member \"" + key + "\" not found");
+        }
+        return it->second;
+    }
+
+    /// @brief Object members in key order
+    const std::map<std::string, JsonValue> &members() const noexcept { return members_; }
+
+private:
+    static void skip_ws(const std::string &s, size_t &pos) {
+        while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) ++pos;
+    }
+
+    static void expect(const std::string &s, size_t &pos, char c) {
+        skip_ws(s, pos);
+        if (pos >= s.size() || s[pos] != c) {
+            throw std::runtime_error(std::string("expected '") + c + "' at offset " + std::to_string(pos));
+        }
+        ++pos;
+    }
+
+    static std::string parse_string(const std::string &s, size_t &pos) {
+        expect(s, pos, '"');
+        std::string out;
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= s.size()) break;
+            char e = s[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                    if (pos + 4 > s.size()) throw std::runtime_error("truncated \\u escape");
+                    out += static_cast<char>(std::strtol(s.substr(pos, 4).c_str(), nullptr, 16) & 0x7F);
+                    pos += 4;
+                    break;
+                default: out += e;
+            }
+        }
+        expect(s, pos, '"');
+        return out;
+    }
+
+    static JsonValue parse_value(const std::string &s, size_t &pos) {
+        skip_ws(s, pos);
+        if (pos >= s.size()) throw std::runtime_error("unexpected end of JSON");
+        JsonValue v;
+        char c = s[pos];
+        if (c == '{') {
+            v.type_ = Type::Object;
+            ++pos;
+            skip_ws(s, pos);
+            if (pos < s.size() && s[pos] == '}') {
+                ++pos;
+                return v;
+            }
+            for (;;) {
+                std::string key = parse_string(s, pos);
+                expect(s, pos, ':');
+                v.members_.emplace(std::move(key), parse_value(s, pos));
+                skip_ws(s, pos);
+                if (pos < s.size() && s[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                expect(s, pos, '}');
+                return v;
+            }
+        }
+        if (c == '[') {
+            v.type_ = Type::Array;
+            ++pos;
+            skip_ws(s, pos);
+            if (pos < s.size() && s[pos] == ']') {
+                ++pos;
+                return v;
+            }
+            for (;;) {
+                v.items_.push_back(parse_value(s, pos));
+                skip_ws(s, pos);
+                if (pos < s.size() && s[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                expect(s, pos, ']');
+                return v;
+            }
+        }
+        if (c == '"') {
+            v.type_ = Type::String;
+            v.string_ = parse_string(s, pos);
+            return v;
+        }
+        for (const char *word : {"true", "false", "null"}) {
+            std::string w(word);
+            if (s.compare(pos, w.size(), w) == 0) {
+                pos += w.size();
+                v.type_ = w == "null" ? Type::Null : Type::Bool;
+                v.string_ = w;
+                return v;
+            }
+        }
+        const char *begin = s.c_str() + pos;
+        char *end = nullptr;
+        v.number_ = std::strtod(begin, &end);
+        if (end == begin) throw std::runtime_error("invalid JSON value at offset " + std::to_string(pos));
+        v.type_ = Type::Number;
+        v.string_.assign(begin, static_cast<size_t>(end - begin));
+        pos += static_cast<size_t>(end - begin);
+        return v;
+    }
+
+    Type type_ = Type::Null;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> items_;
+    std::map<std::string, JsonValue> members_;
+};